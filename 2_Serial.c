@@ -4,7 +4,7 @@
  * This file is part of the SimuSil library
  *
  * Compile: $ gcc -Wall -I./include -pthread -L./lib 2_Serial.c
- *                -lsimusil -lrt -o 2_Serial
+ *                src/journal.c src/checkpoint.c -lsimusil -lrt -o 2_Serial
  *
  * Author: Sergio Romero Montiel <sromero@uma.es>
  *
@@ -17,6 +17,8 @@
 #include <signal.h> /* signal(2), SIGINT, SIG_DFL                     */
 #include <time.h>   /* clock_nanosleep(2)                             */
 #include "simusil.h"
+#include "journal.h"
+#include "checkpoint.h"
 
 /* WORKER STUFF                                                       */
 /* struct to pass all info to thread                                  */
@@ -34,6 +36,7 @@ Bomber_ptr_t b;  /* start/stop bombing                                */
 void destroyer(int signum)
 {
   signal(SIGINT,SIG_DFL); /* restore default-TERM during destroyWorld */
+  journalClose();
   destroyWorld(w);
   exit(EXIT_SUCCESS);
 }
@@ -61,12 +64,17 @@ void searchAndDestroy(Args_t *x)
     printf("[%03d] \tBetween Wait & Read:\n",x->id);
     printf("[%03d] \t\tMissile impacted on ground, or\n",x->id);
     printf("[%03d] \t\tMissile intercepted by a spurious previous shoot\n",x->id);
+    journalLog(JOURNAL_LOST,x->id,0,0,0);
   }
   else
   {
+    journalLog(JOURNAL_SCHEDULE,x->id,0,p.x,p.y);
     printf("[%03d] ---> Moving cannon to position %d\n",x->id,p.x);
+    journalLog(JOURNAL_MOVE_START,x->id,0,p.x,p.y);
     cannonMove(x->c,p.x);
+    journalLog(JOURNAL_MOVE_END,x->id,0,p.x,p.y);
     clock_nanosleep(CLOCK_MONOTONIC,0,&stallTime,NULL); /*espera antes*/
+    journalLog(JOURNAL_FIRE,x->id,0,p.x,p.y);
     cannonFire(x->c);
     /* bucle de monitorizacion hasta intercepcion */
     while ((sm=radarReadMissile(x->r,x->m,&p)) == MISSILE_ACTIVE)
@@ -78,13 +86,16 @@ void searchAndDestroy(Args_t *x)
     {
       case MISSILE_INTERCEPTED:
            printf("[%03d] ---> Interceptado en (%d,%d)\n",x->id,p.x,p.y);
+           journalLog(JOURNAL_INTERCEPT,x->id,0,p.x,p.y);
            break;
       case MISSILE_IMPACTED:
            printf("[%03d] ---> Impacta en suelo (%d)\n",x->id,p.x);
+           journalLog(JOURNAL_IMPACT,x->id,0,p.x,p.y);
            break;
       case MISSILE_ERROR:
       default:
            printf("[%03d] ---> Error de seguimiento del misil\n",x->id);
+           journalLog(JOURNAL_LOST,x->id,0,p.x,p.y);
     }
   }
 
@@ -106,8 +117,10 @@ int main(int argc, char *argv[])
 
   debug_setlevel(1);
 
-  w=createWorld("TRSM 2016",1,2); /* worldname,1 cannon,debug level 2 */
+  /* worldname,1 cannon,debug level 2; SIMUSIL_SNAPSHOT=file restores it */
+  if ((w=worldLoad(NULL,"TRSM 2016",1,2)) == NULL) exit(EXIT_FAILURE);
   b=getBomber(w);
+  journalOpen(NULL,0); /* only if SIMUSIL_JOURNAL=file is set        */
   r=getRadar(w);
   c=getCannon(w,0); /* [0..n-1] cannon number 0 (first of one)        */
 
@@ -122,6 +135,7 @@ int main(int argc, char *argv[])
     x->r=r;
     x->c=c;
     x->m=radarWaitMissile(r);
+    journalLog(JOURNAL_DETECT,x->id,0,0,0);
     searchAndDestroy(x);
   }
   return 0; /* never reached!                                         */
@@ -0,0 +1,391 @@
+/*
+ * File: 7_EventLoop.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Compile: $ gcc -Wall -I./include -pthread -L./lib 7_EventLoop.c
+ *                src/journal.c src/checkpoint.c -lsimusil -lrt -o 7_EventLoop
+ *
+ * Usage:   $ ./7_EventLoop [num_cannons]
+ *
+ * Same engagement as 4_Mutex.c, but every missile is tracked by a small
+ * state machine (Track_t, a few dozen bytes) instead of a whole thread.
+ * A single event loop thread (epoll + timerfd + eventfd) resumes the
+ * tracks when their timer expires or when the cannon finishes with them.
+ * cannonMove() blocks while the cannon travels, so it is executed by one
+ * gunner thread per cannon, never by the event loop.
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include <stdio.h>  /* printf(3)                                      */
+#include <stdlib.h> /* exit(3), EXIT_SUCCESS, malloc(3), atoi(3)      */
+#include <stdint.h> /* uint64_t                                       */
+#include <signal.h> /* signal(2), SIGINT, SIG_DFL, sigaddset(3)       */
+#include <time.h>   /* clock_nanosleep(2), clock_gettime(2)           */
+#include <unistd.h> /* read(2), write(2), close(2), pause(2)          */
+#include <pthread.h>/* pthread stuff (_create,_cancel,_join)          */
+#include <sys/epoll.h>   /* epoll_create1(2), epoll_ctl(2), epoll_wait */
+#include <sys/timerfd.h> /* timerfd_create(2), timerfd_settime(2)     */
+#include <sys/eventfd.h> /* eventfd(2)                                */
+#include "simusil.h"
+#include "journal.h"
+#include "checkpoint.h"
+
+#define MAX_CANNONS 16
+#define MAX_EVENTS  8
+
+/* TRACK STUFF                                                        */
+/* states of the (stackless) searchAndDestroy coroutine               */
+typedef enum{TRACK_READ,TRACK_CANNON,TRACK_FOLLOW,TRACK_DONE}TrackState;
+
+/* one per missile: all the "stack" the coroutine needs               */
+typedef struct{
+  int id;
+  TrackState    state;
+  Missile_ptr_t m;
+  Pos p;
+  struct timespec due;  /* next wakeup when waiting on the timer      */
+} Track_t;
+
+/* GLOBALs: needed by SIGINT handlers                                 */
+World_ptr_t w;   /* to be destroyed at exit                           */
+Bomber_ptr_t b;  /* start/stop bombing                                */
+Radar_ptr_t r;
+List_ptr_t l_new;    /* radar -> loop: new tracks                     */
+List_ptr_t l_jobs;   /* loop -> gunners: tracks waiting for a cannon  */
+List_ptr_t l_done;   /* gunners -> loop: tracks that already fired    */
+int newfd, donefd;   /* eventfd used to wake up the event loop        */
+int nCannons;
+pthread_t loop_thid;
+pthread_t radar_thid;
+pthread_t gunner_thid[MAX_CANNONS];
+
+/* min-heap of tracks sleeping on the timer, ordered by due time      */
+Track_t **heap;
+int heapLen, heapCap;
+
+const struct timespec stallTime=(struct timespec){0, 1000000};/* 1ms */
+const struct timespec relaxTime=(struct timespec){0,10000000};/*10ms */
+
+void destroyTrack(void *arg)
+{
+  free(arg);
+}
+
+void destroyer(int signum)
+{
+  int i;
+
+  signal(SIGINT,SIG_DFL); /* restore default-TERM during destroyWorld */
+  pthread_cancel(loop_thid);
+  pthread_join(loop_thid,NULL);
+  /* no cancel for gunners: cancelled in list_dequeue they would keep
+   * the lock of l_jobs; an empty job tells each one to finish        */
+  for (i=0; i<nCannons; i++) list_enqueue(NULL,-1,l_jobs);
+  for (i=0; i<nCannons; i++) pthread_join(gunner_thid[i],NULL);
+  /* the last one: cancelled inside radarWaitMissile it keeps the lock
+   * of the radar, so nobody else may read the radar after it         */
+  pthread_cancel(radar_thid);
+  pthread_join(radar_thid,NULL);
+  for (i=0; i<heapLen; i++) free(heap[i]);
+  free(heap);
+  destroyList(l_new,destroyTrack);
+  destroyList(l_jobs,destroyTrack);
+  destroyList(l_done,destroyTrack);
+  close(newfd);
+  close(donefd);
+  journalClose();
+  destroyWorld(w);
+  exit(EXIT_SUCCESS);
+}
+
+void handler(int signum)
+{
+  stopBombing(b);
+  printf("Press ctrl+C to finish\n"); /* bad idea: printf in handler! */
+  signal(SIGINT,destroyer);
+}
+
+struct timespec addTime(struct timespec ts, const struct timespec *d)
+{
+  ts.tv_sec += d->tv_sec;
+  ts.tv_nsec += d->tv_nsec;
+  while (ts.tv_nsec >= 1000000000)
+  {
+    ts.tv_nsec -= 1000000000;
+    ++ts.tv_sec;
+  }
+  return ts;
+}
+
+int before(const struct timespec *a, const struct timespec *b)
+{
+  return (a->tv_sec < b->tv_sec) ||
+         (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+/* TIMER HEAP                                                         */
+void heapPush(Track_t *t)
+{
+  int i,parent;
+
+  if (heapLen == heapCap)
+  {
+    heapCap = heapCap ? 2*heapCap : 1024;
+    heap = realloc(heap,heapCap*sizeof(Track_t*));
+  }
+  for (i=heapLen++; i>0; i=parent)
+  {
+    parent=(i-1)/2;
+    if (!before(&t->due,&heap[parent]->due)) break;
+    heap[i]=heap[parent];
+  }
+  heap[i]=t;
+}
+
+Track_t *heapPop(void)
+{
+  Track_t *top=heap[0], *last=heap[--heapLen];
+  int i=0, child;
+
+  while ((child=2*i+1) < heapLen)
+  {
+    if (child+1 < heapLen && before(&heap[child+1]->due,&heap[child]->due))
+      child++;
+    if (!before(&heap[child]->due,&last->due)) break;
+    heap[i]=heap[child];
+    i=child;
+  }
+  heap[i]=last;
+  return top;
+}
+
+/* program the timerfd with the earliest deadline (or disarm it)      */
+void armTimer(int tfd)
+{
+  struct itimerspec its={{0,0},{0,0}};
+
+  if (heapLen > 0) its.it_value=heap[0]->due;
+  timerfd_settime(tfd,TFD_TIMER_ABSTIME,&its,NULL);
+}
+
+/* suspend the track until now+d                                      */
+void sleepTrack(Track_t *t, const struct timespec *d)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC,&now);
+  t->due=addTime(now,d);
+  heapPush(t);
+}
+
+/* wake the event loop from another thread                            */
+void notify(int fd)
+{
+  uint64_t one=1;
+  if (write(fd,&one,sizeof(one)) < 0) perror("write eventfd");
+}
+
+void drain(int fd)
+{
+  uint64_t n;
+  if (read(fd,&n,sizeof(n)) < 0) perror("read eventfd");
+}
+
+
+/* coroutine code: resumed by the loop, never blocks                  */
+void searchAndDestroy(Track_t *x)
+{
+  MissileState sm;
+
+  switch (x->state)
+  {
+    case TRACK_READ:
+      sm=radarReadMissile(r,x->m,&x->p);
+      if (sm != MISSILE_ACTIVE)
+      {
+        printf("[%03d] Warning: missing missile!\n",x->id);
+        printf("[%03d] \tBetween Wait & Read:\n",x->id);
+        printf("[%03d] \t\tMissile impacted on ground, or\n",x->id);
+        printf("[%03d] \t\tMissile intercepted by a spurious previous shoot\n",x->id);
+        journalLog(JOURNAL_LOST,x->id,0,0,0);
+        x->state=TRACK_DONE;
+        break;
+      }
+      journalLog(JOURNAL_SCHEDULE,x->id,0,x->p.x,x->p.y);
+      x->state=TRACK_CANNON;    /* await cannon: gunner resumes us    */
+      list_enqueue(x,x->id,l_jobs);
+      return;
+    case TRACK_CANNON:
+      x->state=TRACK_FOLLOW;
+      /* no break: start following right after the shot               */
+    case TRACK_FOLLOW:
+      /* bucle de monitorizacion hasta intercepcion                   */
+      if ((sm=radarReadMissile(r,x->m,&x->p)) == MISSILE_ACTIVE)
+      {
+        sleepTrack(x,&relaxTime); /* await timer                      */
+        return;
+      }
+      switch (sm)
+      {
+        case MISSILE_INTERCEPTED:
+             printf("[%03d] ---> Interceptado en (%d,%d)\n",x->id,x->p.x,x->p.y);
+             journalLog(JOURNAL_INTERCEPT,x->id,0,x->p.x,x->p.y);
+             break;
+        case MISSILE_IMPACTED:
+             printf("[%03d] ---> Impacta en suelo (%d)\n",x->id,x->p.x);
+             journalLog(JOURNAL_IMPACT,x->id,0,x->p.x,x->p.y);
+             break;
+        case MISSILE_ERROR:
+        default:
+             printf("[%03d] ---> Error de seguimiento del misil\n",x->id);
+             journalLog(JOURNAL_LOST,x->id,0,x->p.x,x->p.y);
+      }
+      x->state=TRACK_DONE;
+      break;
+    case TRACK_DONE:
+    default:
+      break;
+  }
+  free(x);
+}
+
+
+/* gunner thread: owns one cannon, serves tracks waiting to fire      */
+void *gunner(void *arg)
+{
+  int nc=(int)(long)arg;
+  Cannon_ptr_t c=getCannon(w,nc);
+  Track_t *x;
+
+  while ((x=list_dequeue(l_jobs,1)) != NULL)
+  {
+    printf("[%03d] ---> Moving cannon to position %d\n",x->id,x->p.x);
+    journalLog(JOURNAL_MOVE_START,x->id,nc,x->p.x,x->p.y);
+    cannonMove(c,x->p.x);
+    journalLog(JOURNAL_MOVE_END,x->id,nc,x->p.x,x->p.y);
+    clock_nanosleep(CLOCK_MONOTONIC,0,&stallTime,NULL); /*espera antes*/
+    journalLog(JOURNAL_FIRE,x->id,nc,x->p.x,x->p.y);
+    cannonFire(c);
+    clock_nanosleep(CLOCK_MONOTONIC,0,&stallTime,NULL); /*espera despues*/
+    list_enqueue(x,x->id,l_done);
+    notify(donefd);
+  }
+  return NULL;
+}
+
+
+/* event loop thread: resumes tracks on radar, cannon and timer events */
+void *eventLoop(void *arg)
+{
+  struct epoll_event ev, events[MAX_EVENTS];
+  struct timespec now;
+  Track_t *x;
+  int efd, tfd, n, i;
+
+  efd=epoll_create1(0);
+  tfd=timerfd_create(CLOCK_MONOTONIC,0);
+  ev.events=EPOLLIN;
+  ev.data.fd=newfd;  epoll_ctl(efd,EPOLL_CTL_ADD,newfd,&ev);
+  ev.data.fd=donefd; epoll_ctl(efd,EPOLL_CTL_ADD,donefd,&ev);
+  ev.data.fd=tfd;    epoll_ctl(efd,EPOLL_CTL_ADD,tfd,&ev);
+
+  while (1)
+  {
+    n=epoll_wait(efd,events,MAX_EVENTS,-1);
+    for (i=0; i<n; i++)
+    {
+      if (events[i].data.fd == newfd)
+      {
+        drain(newfd);
+        while ((x=list_dequeue(l_new,0)) != NULL) searchAndDestroy(x);
+      }
+      else if (events[i].data.fd == donefd)
+      {
+        drain(donefd);
+        while ((x=list_dequeue(l_done,0)) != NULL) searchAndDestroy(x);
+      }
+      else if (events[i].data.fd == tfd)
+      {
+        drain(tfd);
+        clock_gettime(CLOCK_MONOTONIC,&now);
+        while (heapLen > 0 && !before(&now,&heap[0]->due))
+          searchAndDestroy(heapPop());
+      }
+    }
+    armTimer(tfd);
+  }
+  return NULL; /* never reached!                                      */
+}
+
+
+/* radar thread: wait missile and hands a new track to the event loop */
+void *radarFeeder(void *arg)
+{
+  Track_t *x;
+  static int trackCount=0;
+
+  while(1)
+  {
+    x=(Track_t*)malloc(sizeof(Track_t));
+    x->id=trackCount++;
+    x->state=TRACK_READ;
+    x->m=radarWaitMissile(r);
+    journalLog(JOURNAL_DETECT,x->id,0,0,0);
+    list_enqueue(x,x->id,l_new);
+    notify(newfd);
+  }
+  return NULL; /* never reached!                                      */
+}
+
+
+/*
+ * Main code
+ *
+ * Master thread: starts the threads and waits for ctrl+C
+ */
+int main(int argc, char *argv[])
+{
+  sigset_t set;
+  int i;
+
+  nCannons = (argc > 1) ? atoi(argv[1]) : 1;
+  if (nCannons < 1 || nCannons > MAX_CANNONS)
+  {
+    fprintf(stderr,"Usage: %s [num_cannons (1..%d)]\n",argv[0],MAX_CANNONS);
+    exit(EXIT_FAILURE);
+  }
+
+  debug_setlevel(1);
+
+  /* SIGINT only for main thread, which never waits inside the library:
+   * library and our threads inherit the blocked mask                 */
+  sigemptyset(&set);
+  sigaddset(&set,SIGINT);
+  pthread_sigmask(SIG_BLOCK,&set,NULL);
+  /* worldname,cannons,debug level 2; SIMUSIL_SNAPSHOT=file restores it */
+  if ((w=worldLoad(NULL,"TRSM 2016",nCannons,2)) == NULL) exit(EXIT_FAILURE);
+  b=getBomber(w);
+  r=getRadar(w);
+  journalOpen(NULL,0); /* only if SIMUSIL_JOURNAL=file is set        */
+  l_new=createList("New","track",2);   /* listname,elemname,debuglevel */
+  l_jobs=createList("Jobs","track",2);
+  l_done=createList("Done","track",2);
+  newfd=eventfd(0,0);
+  donefd=eventfd(0,0);
+  pthread_create(&loop_thid,NULL,eventLoop,NULL);
+  for (i=0; i<nCannons; i++)
+    pthread_create(&gunner_thid[i],NULL,gunner,(void*)(long)i);
+  pthread_create(&radar_thid,NULL,radarFeeder,NULL);
+  pthread_sigmask(SIG_UNBLOCK,&set,NULL);
+
+  signal(SIGINT,handler);
+
+  printf("Press ctrl+C to stop bombing\n");
+  startBombing(b);
+  while(1) pause();
+  return 0; /* never reached!                                         */
+}
@@ -0,0 +1,215 @@
+/*
+ * File: 8_Sectors.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Compile: $ gcc -Wall -I./include -pthread -L./lib 8_Sectors.c
+ *                src/sradar.c src/journal.c -lsimusil -lrt -o 8_Sectors
+ *
+ * Usage:   $ ./8_Sectors [num_sectors]
+ *
+ * 4_Mutex.c over a sectorized radar: one sector per cannon. Every sector
+ * has a dispatcher thread that waits for the missiles of its sector and
+ * creates the workers, all of them pinned to the CPU of the sector, and
+ * cannon i (with its own mutex) only fires at missiles of sector i.
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include <stdio.h>  /* printf(3)                                      */
+#include <stdlib.h> /* exit(3), EXIT_SUCCESS, atoi(3)                 */
+#include <signal.h> /* signal(2), SIGINT, SIG_DFL, sigaddset(3)       */
+#include <time.h>   /* clock_nanosleep(2)                             */
+#include <unistd.h> /* pause(2)                                       */
+#include <pthread.h>/* pthread stuff (_create,_exit,_setdettachstate) */
+#include "simusil.h"
+#include "sradar.h"
+#include "journal.h"
+
+#define MAX_SECTORS 16
+
+/* WORKER STUFF                                                       */
+/* struct to pass all info to thread                                  */
+typedef struct{
+  int id;
+  int sector;
+  pthread_t thid;
+  Cannon_ptr_t  c;
+  Missile_ptr_t m;
+} Args_t;
+
+/* GLOBALs: needed by SIGINT handlers                                 */
+World_ptr_t w;   /* to be destroyed at exit                           */
+Bomber_ptr_t b;  /* start/stop bombing                                */
+SRadar_ptr_t sr; /* sectorized radar                                  */
+List_ptr_t l;    /* list of living threads                            */
+pthread_attr_t attr;
+int nSectors;
+pthread_t dispatcher_thid[MAX_SECTORS];
+pthread_mutex_t mutex_canon[MAX_SECTORS];
+
+void destroyWorker(void *arg)
+{
+  Args_t *x=arg;
+  pthread_cancel(x->thid);
+  free(x);
+}
+
+void destroyer(int signum)
+{
+  int i;
+
+  signal(SIGINT,SIG_DFL); /* restore default-TERM during destroyWorld */
+  for (i=0; i<nSectors; i++)
+  {
+    pthread_cancel(dispatcher_thid[i]);
+    pthread_join(dispatcher_thid[i],NULL);
+  }
+  destroyList(l,destroyWorker);
+  pthread_attr_destroy(&attr);
+  journalClose();
+  destroySRadar(sr);
+  destroyWorld(w);
+  exit(EXIT_SUCCESS);
+}
+
+void handler(int signum)
+{
+  stopBombing(b);
+  printf("Press ctrl+C to finish\n"); /* bad idea: printf in handler! */
+  signal(SIGINT,destroyer);
+}
+
+
+/* thread code */
+void *searchAndDestroy(void *arg)
+{
+  Args_t *x=arg;
+  MissileState sm;
+  Pos p;
+  int s=x->sector;
+  const struct timespec stallTime=(struct timespec){0, 1000000};/* 1ms*/
+  const struct timespec relaxTime=(struct timespec){0,10000000};/*10ms*/
+
+  list_enqueue(x,x->id,l);
+  sradarBindThread(sr,s);
+
+  sm=sradarReadMissile(sr,x->m,&s,&p);
+  if (sm != MISSILE_ACTIVE)
+  {
+    printf("[%03d] Warning: missing missile!\n",x->id);
+    printf("[%03d] \tBetween Wait & Read:\n",x->id);
+    printf("[%03d] \t\tMissile impacted on ground, or\n",x->id);
+    printf("[%03d] \t\tMissile intercepted by a spurious previous shoot\n",x->id);
+    journalLog(JOURNAL_LOST,x->id,x->sector,0,0);
+  }
+  else
+  {
+    journalLog(JOURNAL_SCHEDULE,x->id,x->sector,p.x,p.y);
+    pthread_mutex_lock(&mutex_canon[x->sector]); /*reserva de cañon*/
+    printf("[%03d] ---> Moving cannon %d to position %d\n",x->id,x->sector,p.x);
+    journalLog(JOURNAL_MOVE_START,x->id,x->sector,p.x,p.y);
+    cannonMove(x->c,p.x);
+    journalLog(JOURNAL_MOVE_END,x->id,x->sector,p.x,p.y);
+    clock_nanosleep(CLOCK_MONOTONIC,0,&stallTime,NULL); /*espera antes*/
+    journalLog(JOURNAL_FIRE,x->id,x->sector,p.x,p.y);
+    cannonFire(x->c);
+    pthread_mutex_unlock(&mutex_canon[x->sector]); /*liberar cañon*/
+    /* bucle de monitorizacion hasta intercepcion */
+    while ((sm=sradarReadMissile(sr,x->m,&s,&p)) == MISSILE_ACTIVE)
+    {
+      clock_nanosleep(CLOCK_MONOTONIC,0,&relaxTime,NULL);
+    }
+    switch (sm)
+    {
+      case MISSILE_INTERCEPTED:
+           printf("[%03d] ---> Interceptado en (%d,%d)\n",x->id,p.x,p.y);
+           journalLog(JOURNAL_INTERCEPT,x->id,x->sector,p.x,p.y);
+           break;
+      case MISSILE_IMPACTED:
+           printf("[%03d] ---> Impacta en suelo (%d)\n",x->id,p.x);
+           journalLog(JOURNAL_IMPACT,x->id,x->sector,p.x,p.y);
+           break;
+      case MISSILE_ERROR:
+      default:
+           printf("[%03d] ---> Error de seguimiento del misil\n",x->id);
+           journalLog(JOURNAL_LOST,x->id,x->sector,p.x,p.y);
+    }
+  }
+
+  list_remove(x,l);
+  free(x);
+  pthread_exit(NULL);
+}
+
+
+/* dispatcher code: one per sector, creates dettached workers         */
+void *dispatcher(void *arg)
+{
+  int s=(int)(long)arg;
+  Cannon_ptr_t c=getCannon(w,s);
+  Args_t *x;
+  static int workerCount=0;
+
+  sradarBindThread(sr,s);
+  while(1)
+  {
+    x=(Args_t*)malloc(sizeof(Args_t));
+    x->id=__atomic_fetch_add(&workerCount,1,__ATOMIC_RELAXED);
+    x->sector=s;
+    x->c=c;
+    x->m=sradarWaitMissile(sr,s);
+    journalLog(JOURNAL_DETECT,x->id,s,0,0);
+    pthread_create(&x->thid,&attr,searchAndDestroy,(void*)x);
+  }
+  return NULL; /* never reached!                                      */
+}
+
+
+/*
+ * Main code
+ *
+ * Master thread: creates the sectors and waits for ctrl+C
+ */
+int main(int argc, char *argv[])
+{
+  sigset_t set;
+  int i;
+
+  nSectors = (argc > 1) ? atoi(argv[1]) : 4;
+  if (nSectors < 1 || nSectors > MAX_SECTORS)
+  {
+    fprintf(stderr,"Usage: %s [num_sectors (1..%d)]\n",argv[0],MAX_SECTORS);
+    exit(EXIT_FAILURE);
+  }
+
+  debug_setlevel(1);
+
+  w=createWorld("TRSM 2016",nSectors,2); /* one cannon per sector    */
+  b=getBomber(w);
+  journalOpen(NULL,0); /* only if SIMUSIL_JOURNAL=file is set        */
+  l=createList("Threads","worker",2); /* listname,elemname,debuglevel */
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr,PTHREAD_CREATE_DETACHED);
+
+  /* SIGINT only for main thread: destroyer cancels the other ones  */
+  sigemptyset(&set);
+  sigaddset(&set,SIGINT);
+  pthread_sigmask(SIG_BLOCK,&set,NULL);
+  sr=createSRadar(getRadar(w),nSectors,0,0,2); /* default width/period */
+  for (i=0; i<nSectors; i++)
+  {
+    pthread_mutex_init(&mutex_canon[i],NULL);
+    pthread_create(&dispatcher_thid[i],NULL,dispatcher,(void*)(long)i);
+  }
+  pthread_sigmask(SIG_UNBLOCK,&set,NULL);
+
+  signal(SIGINT,handler);
+
+  printf("Press ctrl+C to stop bombing\n");
+  startBombing(b);
+  while(1) pause();
+  return 0; /* never reached!                                         */
+}
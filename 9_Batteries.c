@@ -0,0 +1,258 @@
+/*
+ * File: 9_Batteries.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Compile: $ gcc -Wall -I./include -pthread -L./lib 9_Batteries.c
+ *                src/board.c -lsimusil -lrt -o 9_Batteries
+ *
+ * Usage:   $ ./9_Batteries [num_batteries] [cannons_per_battery]
+ *
+ * Every battery is a separate process. The World process (the parent)
+ * owns the sky: it publishes the missiles of its Radar in a threat board
+ * in shared memory [board.h] and fires the cannons on behalf of the
+ * batteries. Battery processes claim tracks from the board (CAS on the
+ * owner word, with a lease) and order their own cannons to shoot, so a
+ * missile is never engaged twice and a track claimed by a battery that
+ * dies is taken by another one once the lease expires.
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include <stdio.h>  /* printf(3)                                      */
+#include <stdlib.h> /* exit(3), EXIT_SUCCESS, atoi(3)                 */
+#include <signal.h> /* signal(2), SIGINT, SIG_DFL, sigaddset(3)       */
+#include <time.h>   /* clock_nanosleep(2)                             */
+#include <unistd.h> /* fork(2), _exit(2)                              */
+#include <pthread.h>/* pthread stuff (_create,_join,_mutex)           */
+#include <sys/wait.h>/* waitpid(2)                                    */
+#include "simusil.h"
+#include "board.h"
+
+#define MAX_BATTERIES 8
+#define MAX_CANNONS   8  /* per battery                               */
+#define MAX_TRACKS    BOARD_TRACKS
+
+/* WORLD PROCESS STUFF                                                */
+/* missiles of the Radar published in the board                       */
+typedef struct{
+  long seq;
+  Missile_ptr_t m;
+} Track_t;
+
+/* GLOBALs: needed by SIGINT handlers                                 */
+World_ptr_t w;   /* to be destroyed at exit                           */
+Bomber_ptr_t b;  /* start/stop bombing                                */
+Radar_ptr_t r;
+Board_ptr_t board;
+int nBatteries, nCannons;
+pid_t battery_pid[MAX_BATTERIES];
+pthread_t cannon_thid[MAX_BATTERIES*MAX_CANNONS];
+pthread_t follower_thid;
+pthread_t publisher_thid;
+Track_t tracks[MAX_TRACKS];
+int nTracks=0;
+pthread_mutex_t mutex_tracks=PTHREAD_MUTEX_INITIALIZER;
+
+const struct timespec stallTime=(struct timespec){0, 1000000};/* 1ms */
+const struct timespec relaxTime=(struct timespec){0,10000000};/*10ms */
+const struct timespec idleTime =(struct timespec){0, 5000000};/* 5ms */
+
+void destroyer(int signum)
+{
+  int i;
+
+  signal(SIGINT,SIG_DFL); /* restore default-TERM during destroyWorld */
+  boardShutdown(board);   /* batteries and threads see it and finish  */
+  pthread_cancel(publisher_thid);  /* blocked in radarWaitMissile     */
+  pthread_join(publisher_thid,NULL);
+  for (i=0; i<nBatteries; i++) waitpid(battery_pid[i],NULL,0);
+  for (i=0; i<nBatteries*nCannons; i++) pthread_join(cannon_thid[i],NULL);
+  pthread_join(follower_thid,NULL);
+  destroyWorld(w);
+  boardDestroy(board,BOARD_NAME);
+  exit(EXIT_SUCCESS);
+}
+
+void handler(int signum)
+{
+  stopBombing(b);
+  printf("Press ctrl+C to finish\n"); /* bad idea: printf in handler! */
+  signal(SIGINT,destroyer);
+}
+
+/* cannon thread: carries out the orders of the owner battery         */
+void *cannonServer(void *arg)
+{
+  int nc=(int)(long)arg;
+  Cannon_ptr_t c=getCannon(w,nc);
+  int x;
+
+  while ((x=boardCannonNext(board,nc)) >= 0)
+  {
+    cannonMove(c,x);
+    clock_nanosleep(CLOCK_MONOTONIC,0,&stallTime,NULL); /*espera antes*/
+    cannonFire(c);
+    clock_nanosleep(CLOCK_MONOTONIC,0,&stallTime,NULL); /*espera despues*/
+    boardCannonDone(board,nc);
+  }
+  return NULL;
+}
+
+/* follower thread: keeps the tracks of the board up to date          */
+void *follower(void *arg)
+{
+  MissileState sm;
+  Pos p;
+  int i;
+
+  while (!boardIsShutdown(board))
+  {
+    pthread_mutex_lock(&mutex_tracks);
+    for (i=0; i<nTracks; )
+    {
+      sm=radarReadMissile(r,tracks[i].m,&p);
+      boardUpdate(board,tracks[i].seq,sm,p);
+      if (sm != MISSILE_ACTIVE) tracks[i]=tracks[--nTracks];
+      else i++;
+    }
+    pthread_mutex_unlock(&mutex_tracks);
+    clock_nanosleep(CLOCK_MONOTONIC,0,&relaxTime,NULL);
+  }
+  return NULL;
+}
+
+
+/* publisher thread: every new missile of the Radar goes to the board */
+void *publisher(void *arg)
+{
+  Missile_ptr_t m;
+  Pos p;
+  long seq;
+  int full;
+
+  while(1)
+  {
+    m=radarWaitMissile(r);
+    if (radarReadMissile(r,m,&p) != MISSILE_ACTIVE) continue;
+    pthread_mutex_lock(&mutex_tracks);
+    if ((full=(nTracks == MAX_TRACKS)) == 0)
+    {
+      /* published only if followed: never an ACTIVE track forever    */
+      seq=boardPublish(board,p);
+      tracks[nTracks].seq=seq;
+      tracks[nTracks++].m=m;
+    }
+    pthread_mutex_unlock(&mutex_tracks);
+    if (full) fprintf(stderr,"Publisher: missile not published, MAX_TRACKS too small\n");
+  }
+  return NULL; /* never reached!                                      */
+}
+
+
+/* BATTERY PROCESS STUFF                                              */
+typedef struct{
+  int battery;
+  int cannon;
+  Board_ptr_t board;
+} Args_t;
+
+/* engagement thread: one per cannon of the battery                   */
+void *engage(void *arg)
+{
+  Args_t *x=arg;
+  long seq;
+  Pos p;
+
+  while (!boardIsShutdown(x->board))
+  {
+    if ((seq=boardClaim(x->board,x->battery,&p)) < 0)
+    {
+      clock_nanosleep(CLOCK_MONOTONIC,0,&idleTime,NULL);
+      continue;
+    }
+    printf("[B%d] [%03ld] ---> Moving cannon %d to position %d\n",
+           x->battery,seq,x->cannon,p.x);
+    if (boardCannonFire(x->board,x->cannon,p.x,seq,x->battery) < 0) break;
+    if (!boardFired(x->board,seq,x->battery)) /* lease lost meanwhile  */
+      printf("[B%d] [%03ld] Track taken by another battery\n",x->battery,seq);
+  }
+  return NULL;
+}
+
+/* body of every battery process                                      */
+void battery(int id)
+{
+  pthread_t thid[MAX_CANNONS];
+  Args_t x[MAX_CANNONS];
+  Board_ptr_t bb;
+  int i;
+
+  signal(SIGINT,SIG_IGN);  /* the World process tells us when to end */
+  if ((bb=boardAttach(BOARD_NAME)) == NULL) _exit(EXIT_FAILURE);
+  printf("[B%d] Battery ready with cannons %d..%d\n",id,id*nCannons,(id+1)*nCannons-1);
+  for (i=0; i<nCannons; i++)
+  {
+    x[i]=(Args_t){id,id*nCannons+i,bb};
+    pthread_create(&thid[i],NULL,engage,&x[i]);
+  }
+  for (i=0; i<nCannons; i++) pthread_join(thid[i],NULL);
+  boardDetach(bb);
+  fflush(stdout);
+  _exit(EXIT_SUCCESS);
+}
+
+
+/*
+ * Main code
+ *
+ * World process: forks the batteries and serves their cannons
+ */
+int main(int argc, char *argv[])
+{
+  sigset_t set;
+  int i;
+
+  nBatteries = (argc > 1) ? atoi(argv[1]) : 2;
+  nCannons = (argc > 2) ? atoi(argv[2]) : 1;
+  if (nBatteries < 1 || nBatteries > MAX_BATTERIES ||
+      nCannons < 1 || nCannons > MAX_CANNONS)
+  {
+    fprintf(stderr,"Usage: %s [num_batteries (1..%d)] [cannons_per_battery (1..%d)]\n",
+            argv[0],MAX_BATTERIES,MAX_CANNONS);
+    exit(EXIT_FAILURE);
+  }
+
+  if ((board=boardCreate(BOARD_NAME,nBatteries*nCannons)) == NULL)
+    exit(EXIT_FAILURE);
+
+  /* fork before createWorld: batteries never touch the World         */
+  fflush(stdout);
+  for (i=0; i<nBatteries; i++)
+    if ((battery_pid[i]=fork()) == 0) battery(i);
+
+  debug_setlevel(1);
+
+  /* SIGINT only for main thread, which never waits inside the library:
+   * library and our threads inherit the blocked mask                 */
+  sigemptyset(&set);
+  sigaddset(&set,SIGINT);
+  pthread_sigmask(SIG_BLOCK,&set,NULL);
+  w=createWorld("TRSM 2016",nBatteries*nCannons,2); /* all the cannons */
+  b=getBomber(w);
+  r=getRadar(w);
+  for (i=0; i<nBatteries*nCannons; i++)
+    pthread_create(&cannon_thid[i],NULL,cannonServer,(void*)(long)i);
+  pthread_create(&follower_thid,NULL,follower,NULL);
+  pthread_create(&publisher_thid,NULL,publisher,NULL);
+  pthread_sigmask(SIG_UNBLOCK,&set,NULL);
+
+  signal(SIGINT,handler);
+
+  printf("Press ctrl+C to stop bombing\n");
+  startBombing(b);
+  while(1) pause();
+  return 0; /* never reached!                                         */
+}
@@ -0,0 +1,637 @@
+/*
+ * File: microbench.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Microbenchmarks of the primitives the engagement loop is built on:
+ * lists, radar, cannon and missile generation. Every benchmark runs some
+ * warmup repetitions and then -r measured repetitions on pinned threads;
+ * the table shows min/p50/p90/p99/max of the repetitions and the same
+ * numbers are written as JSON (one result per line). With -c the p50 of
+ * every result is compared against a previous JSON file.
+ *
+ * Compile: $ make bench/microbench
+ *
+ * Usage:   $ ./bench/microbench [-r reps] [-w warmup] [-t max_threads]
+ *                [-o out.json] [-c baseline.json] [-T tolerance] [-v]
+ *          $ make microbench            // run, compare with baseline.json
+ *          $ make microbench-baseline   // run and save bench/baseline.json
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#define _GNU_SOURCE   /* pthread_attr_setaffinity_np(3), CPU_SET(3)   */
+#include <stdio.h>    /* printf(3), fprintf(3), fopen(3)              */
+#include <stdlib.h>   /* exit(3), malloc(3), qsort(3), atoi(3)        */
+#include <stdint.h>   /* uint64_t                                     */
+#include <string.h>   /* strcmp(3)                                    */
+#include <math.h>     /* ceil(3)                                      */
+#include <time.h>     /* clock_gettime(2), clock_nanosleep(2)         */
+#include <unistd.h>   /* getopt(3), sysconf(3), dup(2), sleep(3)      */
+#include <fcntl.h>    /* open(2)                                      */
+#include <pthread.h>  /* pthread stuff (_create,_join,_barrier)       */
+#include <semaphore.h>/* sem_init(3), sem_wait(3), sem_post(3)        */
+#include <sched.h>    /* cpu_set_t                                    */
+#include "simusil.h"
+#include "sradar.h"
+
+/* not in simusil.h: the function the Bomber calls for every missile  */
+void generateMissile(World_ptr_t);
+
+#define MAX_RESULTS 128
+#define MAX_THREADS 64
+#define LIST_OPS    20000  /* list operations per thread and rep      */
+#define READ_OPS    20000  /* radar reads per rep                     */
+#define CANNON_OPS  100    /* cannon calls per rep                    */
+#define GEN_OPS     100    /* missiles generated per rep              */
+#define PREFILL     32     /* elements in the ordered list            */
+#define SHELL_FLIGHT 2     /* s for a shell to leave the sky          */
+
+/* HARNESS                                                            */
+typedef struct{
+  char name[64];
+  int threads;
+  int param;
+  const char *unit;
+  int n;
+  double min, p50, p90, p99, max;
+}Result;
+
+Result results[MAX_RESULTS];
+int nresults=0;
+int reps=20, warmup=3, maxThreads=MAX_THREADS, verbose=0;
+long ncpu=1;
+FILE *out;              /* report (stdout is the library chatter)     */
+
+uint64_t nowNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (uint64_t)ts.tv_sec*1000000000ULL+ts.tv_nsec;
+}
+
+int cmpDouble(const void *a, const void *b)
+{
+  double x=*(const double*)a, y=*(const double*)b;
+  return (x > y) - (x < y);
+}
+
+double percentile(double *s, int n, double q)
+{
+  int i=(int)ceil(q*n)-1;
+  return s[i < 0 ? 0 : i];
+}
+
+/* sort the samples and keep the summary                              */
+void record(const char *name, int threads, int param, const char *unit,
+            double *s, int n)
+{
+  Result *r;
+
+  if (nresults == MAX_RESULTS || n == 0) return;
+  r=&results[nresults++];
+  qsort(s,n,sizeof(double),cmpDouble);
+  snprintf(r->name,sizeof(r->name),"%s",name);
+  r->threads=threads;
+  r->param=param;
+  r->unit=unit;
+  r->n=n;
+  r->min=s[0];
+  r->p50=percentile(s,n,0.50);
+  r->p90=percentile(s,n,0.90);
+  r->p99=percentile(s,n,0.99);
+  r->max=s[n-1];
+  fprintf(out,"%-24s %3d %6d %-6s %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+          r->name,r->threads,r->param,r->unit,
+          r->min,r->p50,r->p90,r->p99,r->max);
+  fflush(out);
+}
+
+void pinSelf(int cpu)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % ncpu,&set);
+  pthread_setaffinity_np(pthread_self(),sizeof(set),&set);
+}
+
+/* run fn(arg,i) on nthreads pinned threads released by a barrier     */
+typedef struct{
+  void (*fn)(void*,int);
+  void *arg;
+  int id;
+  pthread_barrier_t *bar;
+  uint64_t start, end;
+}Worker_t;
+
+void *workerMain(void *p)
+{
+  Worker_t *x=p;
+  pthread_barrier_wait(x->bar);
+  x->start=nowNs();
+  x->fn(x->arg,x->id);
+  x->end=nowNs();
+  return NULL;
+}
+
+/* Return value: ns from the first thread start to the last one end   */
+uint64_t runThreads(int nthreads, void (*fn)(void*,int), void *arg)
+{
+  pthread_t th[MAX_THREADS];
+  Worker_t x[MAX_THREADS];
+  pthread_attr_t attr;
+  pthread_barrier_t bar;
+  cpu_set_t set;
+  uint64_t start=UINT64_MAX, end=0;
+  int i;
+
+  pthread_barrier_init(&bar,NULL,nthreads+1);
+  for (i=0; i<nthreads; i++)
+  {
+    x[i]=(Worker_t){fn,arg,i,&bar,0,0};
+    pthread_attr_init(&attr);
+    CPU_ZERO(&set);
+    CPU_SET(i % ncpu,&set);
+    pthread_attr_setaffinity_np(&attr,sizeof(set),&set);
+    pthread_create(&th[i],&attr,workerMain,&x[i]);
+    pthread_attr_destroy(&attr);
+  }
+  pthread_barrier_wait(&bar);
+  for (i=0; i<nthreads; i++)
+  {
+    pthread_join(th[i],NULL);
+    if (x[i].start < start) start=x[i].start;
+    if (x[i].end > end) end=x[i].end;
+  }
+  pthread_barrier_destroy(&bar);
+  return end-start;
+}
+
+/* warmup + reps; sample = ns per operation over all threads          */
+void runRepeated(const char *name, int nthreads, int param, long ops,
+                 void (*fn)(void*,int), void *arg)
+{
+  double *s=malloc(reps*sizeof(double));
+  uint64_t ns;
+  int i;
+
+  for (i=0; i<warmup; i++) runThreads(nthreads,fn,arg);
+  for (i=0; i<reps; i++)
+  {
+    ns=runThreads(nthreads,fn,arg);
+    s[i]=(double)ns/ops;
+  }
+  record(name,nthreads,param,"ns/op",s,reps);
+  free(s);
+}
+
+/* LIST BENCHMARKS                                                    */
+int cmpInt(void *a, void *b)
+{
+  return *(int*)a > *(int*)b;
+}
+
+void listEnqDeq(void *arg, int id)
+{
+  List_ptr_t l=arg;
+  int i, token=id;
+
+  for (i=0; i<LIST_OPS/2; i++)
+  {
+    list_enqueue(&token,id,l);
+    list_dequeue(l,0);
+  }
+}
+
+void listInsRem(void *arg, int id)
+{
+  List_ptr_t l=arg;
+  int i, key;
+
+  for (i=0; i<LIST_OPS/2; i++)
+  {
+    key=(id*7919+i)%PREFILL;
+    list_insert(&key,cmpInt,id,l);
+    list_remove(&key,l);
+  }
+}
+
+void benchLists(void)
+{
+  static int keys[PREFILL];
+  List_ptr_t l;
+  int t, i;
+
+  for (t=1; t<=maxThreads; t*=2)
+  {
+    l=createList("Bench","item",1);
+    runRepeated("list_enqueue_dequeue",t,0,(long)t*LIST_OPS,listEnqDeq,l);
+    destroyList(l,NULL);
+  }
+  for (t=1; t<=maxThreads; t*=2)
+  {
+    l=createList("Bench","item",1);
+    for (i=0; i<PREFILL; i++)
+    {
+      keys[i]=i;
+      list_insert(&keys[i],cmpInt,i,l);
+    }
+    runRepeated("list_insert_remove",t,PREFILL,(long)t*LIST_OPS,listInsRem,l);
+    destroyList(l,NULL);
+  }
+}
+
+
+/* RADAR BENCHMARKS                                                   */
+typedef struct{
+  Radar_ptr_t r;
+  SRadar_ptr_t sr;
+  Missile_ptr_t *m;
+  int *sector;
+  int n;
+  int nthreads;
+}Sky_t;
+
+void benchRadarReads(void *arg, int id)
+{
+  Sky_t *sky=arg;
+  Pos p;
+  int i, n=READ_OPS/sky->nthreads;
+
+  for (i=0; i<n; i++)
+    radarReadMissile(sky->r,sky->m[(id+i*31)%sky->n],&p);
+}
+
+void benchSRadarReads(void *arg, int id)
+{
+  Sky_t *sky=arg;
+  Pos p;
+  int i, k, s, n=READ_OPS/sky->nthreads;
+
+  for (i=0; i<n; i++)
+  {
+    k=(id+i*31)%sky->n;
+    s=sky->sector[k];
+    sradarReadMissile(sky->sr,sky->m[k],&s,&p);
+  }
+}
+
+/* a fresh World for every benchmark: no missiles left from the last
+ * one, and a waiter cancelled inside radarWaitMissile() leaves the
+ * lock of Radar.New taken, so that Radar can not be waited on again    */
+World_ptr_t newWorld(void)
+{
+  return createWorld("Bench",1,1);
+}
+
+/* launch n missiles and take them from the Radar                     */
+void fillSky(World_ptr_t w, Sky_t *sky, int n)
+{
+  int i;
+
+  sky->r=getRadar(w);
+  sky->n=n;
+  sky->m=realloc(sky->m,n*sizeof(Missile_ptr_t));
+  sky->sector=realloc(sky->sector,n*sizeof(int));
+  for (i=0; i<n; i++) generateMissile(w);
+  for (i=0; i<n; i++) sky->m[i]=radarWaitMissile(sky->r);
+}
+
+/* launch n missiles and take them from the sectors of the SRadar     */
+void fillSectors(World_ptr_t w, Sky_t *sky, int n)
+{
+  int i, s;
+  struct timespec ms={0,1000000};
+
+  sky->n=n;
+  sky->m=realloc(sky->m,n*sizeof(Missile_ptr_t));
+  sky->sector=realloc(sky->sector,n*sizeof(int));
+  for (i=0; i<n; i++) generateMissile(w);
+  for (i=0; i<n; )
+  {
+    for (s=0; s<sradarNumSectors(sky->sr) && i<n; s++)
+      while (i<n && (sky->m[i]=sradarPollMissile(sky->sr,s)) != NULL)
+        sky->sector[i++]=s;
+    if (i < n) clock_nanosleep(CLOCK_MONOTONIC,0,&ms,NULL);
+  }
+}
+
+void benchRadar(void)
+{
+  static const int airborne[]={1,10,100,1000};
+  World_ptr_t w;
+  Sky_t sky={0};
+  char name[64];
+  int i, k, t;
+
+  /* single reader, growing sky                                       */
+  sky.nthreads=1;
+  for (i=0; i<sizeof(airborne)/sizeof(airborne[0]); i++)
+  {
+    w=newWorld();
+    fillSky(w,&sky,airborne[i]);
+    runRepeated("radar_read",1,airborne[i],READ_OPS,benchRadarReads,&sky);
+    destroyWorld(w);
+  }
+
+  /* 8 readers, 100 missiles: one Radar vs K sectors                  */
+  t = maxThreads < 8 ? maxThreads : 8;
+  sky.nthreads=t;
+  w=newWorld();
+  fillSky(w,&sky,100);
+  runRepeated("radar_read",t,100,READ_OPS,benchRadarReads,&sky);
+  destroyWorld(w);
+  for (k=1; k<=8; k*=2)
+  {
+    snprintf(name,sizeof(name),"sradar_read_k%d",k);
+    w=newWorld();
+    sky.sr=createSRadar(getRadar(w),k,0,0,1);
+    fillSectors(w,&sky,100);
+    runRepeated(name,t,100,READ_OPS,benchSRadarReads,&sky);
+    destroySRadar(sky.sr);
+    destroyWorld(w);
+  }
+
+  free(sky.m);
+  free(sky.sector);
+}
+
+/* back end of the SRadar: one direct Radar reader while the refreshers
+ * of K sectors follow 1000 missiles (radar_read 1 1000 is the floor).
+ * A new World every rep: no missile reaches the ground meanwhile     */
+void benchRadarBackEnd(void)
+{
+  World_ptr_t w;
+  Sky_t sky={0};
+  double *s=malloc(reps*sizeof(double));
+  char name[64];
+  uint64_t ns;
+  int i, k;
+
+  sky.nthreads=1;
+  for (k=1; k<=8; k*=2)
+  {
+    snprintf(name,sizeof(name),"radar_read_sradar_k%d",k);
+    for (i=-warmup; i<reps; i++)
+    {
+      w=newWorld();
+      sky.r=getRadar(w);
+      sky.sr=createSRadar(sky.r,k,0,0,1);
+      fillSectors(w,&sky,1000);
+      ns=runThreads(1,benchRadarReads,&sky);
+      if (i >= 0) s[i]=(double)ns/READ_OPS;
+      destroySRadar(sky.sr);
+      destroyWorld(w);
+    }
+    record(name,1,1000,"ns/op",s,reps);
+  }
+  free(s);
+  free(sky.m);
+  free(sky.sector);
+}
+
+/* generateMissile() called -> radarWaitMissile() returns: includes
+ * generate_missile, the missile is queued before its timer is armed
+ * and the waiter may run before generateMissile() returns            */
+sem_t woken;
+uint64_t wokenAt;
+
+void *waiter(void *arg)
+{
+  Radar_ptr_t r=arg;
+
+  pinSelf(1);
+  while (1)
+  {
+    radarWaitMissile(r);
+    wokenAt=nowNs();
+    sem_post(&woken);
+  }
+  return NULL;
+}
+
+void benchWakeup(void)
+{
+  World_ptr_t w=newWorld();
+  int i, n=10*reps;
+  double *s=malloc(n*sizeof(double));
+  pthread_t th;
+  uint64_t t0;
+  struct timespec gap={0,2000000}; /* 2ms: waiter is sleeping again   */
+
+  sem_init(&woken,0,0);
+  pthread_create(&th,NULL,waiter,getRadar(w));
+  for (i=-warmup; i<n; i++)
+  {
+    clock_nanosleep(CLOCK_MONOTONIC,0,&gap,NULL);
+    t0=nowNs();
+    generateMissile(w);
+    sem_wait(&woken);
+    if (i >= 0) s[i]=(double)(wokenAt-t0);
+  }
+  record("generate_wakeup",1,0,"ns",s,n);
+  pthread_cancel(th);
+  pthread_join(th,NULL);
+  sem_destroy(&woken);
+  free(s);
+  destroyWorld(w);
+}
+
+
+/* CANNON AND MISSILE BENCHMARKS                                      */
+void cannonMoveSame(void *arg, int id)
+{
+  int i;
+  for (i=0; i<CANNON_OPS; i++) cannonMove(arg,0);
+}
+
+void cannonFireOnly(void *arg, int id)
+{
+  int i;
+  for (i=0; i<CANNON_OPS; i++) cannonFire(arg);
+}
+
+void cannonMoveFire(void *arg, int id)
+{
+  int i;
+  for (i=0; i<CANNON_OPS; i++)
+  {
+    cannonMove(arg,0);
+    cannonFire(arg);
+  }
+}
+
+void generate(void *arg, int id)
+{
+  int i;
+  for (i=0; i<GEN_OPS; i++) generateMissile(arg);
+}
+
+void benchCannon(void)
+{
+  World_ptr_t w=newWorld();
+  Cannon_ptr_t c=getCannon(w,0);
+
+  cannonMove(c,0);
+  runRepeated("cannon_move_same",1,0,CANNON_OPS,cannonMoveSame,c);
+  runRepeated("cannon_fire",1,0,CANNON_OPS,cannonFireOnly,c);
+  runRepeated("cannon_move_fire",1,0,CANNON_OPS,cannonMoveFire,c);
+  sleep(SHELL_FLIGHT); /* destroyWorld under flying shells may crash */
+  destroyWorld(w);
+}
+
+void benchGenerate(void)
+{
+  World_ptr_t w=newWorld();
+  Radar_ptr_t r=getRadar(w);
+  double *s=malloc(reps*sizeof(double));
+  uint64_t ns;
+  int i, k;
+
+  for (i=-warmup; i<reps; i++)
+  {
+    ns=runThreads(1,generate,w);
+    if (i >= 0) s[i]=(double)ns/GEN_OPS;
+    for (k=0; k<GEN_OPS; k++) radarWaitMissile(r); /* drain Radar.New */
+  }
+  record("generate_missile",1,0,"ns/op",s,reps);
+  free(s);
+  destroyWorld(w);
+}
+
+
+/* JSON OUTPUT AND BASELINE                                           */
+void writeJson(const char *path)
+{
+  FILE *f;
+  int i;
+
+  if ((f=fopen(path,"w")) == NULL)
+  {
+    perror(path);
+    return;
+  }
+  fprintf(f,"{\n  \"benchmark\": \"simusil-microbench\",\n");
+  fprintf(f,"  \"reps\": %d, \"warmup\": %d, \"cpus\": %ld,\n",reps,warmup,ncpu);
+  fprintf(f,"  \"results\": [\n");
+  for (i=0; i<nresults; i++)
+  {
+    Result *r=&results[i];
+    fprintf(f,"    {\"name\": \"%s\", \"threads\": %d, \"param\": %d, "
+              "\"unit\": \"%s\", \"n\": %d, \"min\": %.1f, \"p50\": %.1f, "
+              "\"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f}%s\n",
+            r->name,r->threads,r->param,r->unit,r->n,
+            r->min,r->p50,r->p90,r->p99,r->max,
+            i+1 < nresults ? "," : "");
+  }
+  fprintf(f,"  ]\n}\n");
+  fclose(f);
+  fprintf(out,"Results written to %s\n",path);
+}
+
+/* Return value: number of results whose p50 grew more than tol       */
+int compareJson(const char *path, double tol)
+{
+  FILE *f;
+  char line[512], name[64], unit[16];
+  int threads, param, n, i, found, bad=0;
+  double min, p50;
+
+  if ((f=fopen(path,"r")) == NULL)
+  {
+    perror(path);
+    return 0;
+  }
+  fprintf(out,"Comparing p50 with %s (tolerance %.0f%%)\n",path,100*tol);
+  while (fgets(line,sizeof(line),f))
+  {
+    if (sscanf(line," {\"name\": \"%63[^\"]\", \"threads\": %d, \"param\": %d, "
+                    "\"unit\": \"%15[^\"]\", \"n\": %d, \"min\": %lf, \"p50\": %lf",
+               name,&threads,&param,unit,&n,&min,&p50) != 7) continue;
+    for (i=found=0; i<nresults && !found; i++)
+    {
+      Result *r=&results[i];
+      if (strcmp(r->name,name) || r->threads != threads || r->param != param)
+        continue;
+      found=1;
+      if (r->p50 > p50*(1+tol))
+      {
+        fprintf(out,"  REGRESSION %-24s %3d %6d: %10.1f -> %10.1f %s (+%.0f%%)\n",
+                name,threads,param,p50,r->p50,unit,100*(r->p50/p50-1));
+        bad++;
+      }
+    }
+  }
+  fclose(f);
+  fprintf(out,"%d regression(s)\n",bad);
+  return bad;
+}
+
+void usage(char *prog)
+{
+  fprintf(stderr,"Usage: %s [-r reps] [-w warmup] [-t max_threads] "
+                 "[-o out.json] [-c baseline.json] [-T tolerance] [-v]\n",prog);
+  exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Main code
+ *
+ * Runs every benchmark over Worlds that are never bombed: the missiles
+ * are launched by hand with generateMissile()
+ */
+int main(int argc, char *argv[])
+{
+  const char *json="microbench.json", *baseline=NULL;
+  double tol=0.25;
+  int opt, fd, bad=0;
+
+  while ((opt=getopt(argc,argv,"r:w:t:o:c:T:v")) != -1)
+  {
+    switch (opt)
+    {
+      case 'r': reps=atoi(optarg);     break;
+      case 'w': warmup=atoi(optarg);   break;
+      case 't': maxThreads=atoi(optarg); break;
+      case 'o': json=optarg;           break;
+      case 'c': baseline=optarg;       break;
+      case 'T': tol=atof(optarg);      break;
+      case 'v': verbose=1;             break;
+      default:  usage(argv[0]);
+    }
+  }
+  if (reps < 1 || warmup < 0 || maxThreads < 1 || maxThreads > MAX_THREADS)
+    usage(argv[0]);
+  ncpu=sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncpu < 1) ncpu=1;
+
+  /* the library prints to stdout: keep the report apart              */
+  out=fdopen(dup(STDOUT_FILENO),"w");
+  if (!verbose && (fd=open("/dev/null",O_WRONLY)) >= 0)
+  {
+    fflush(stdout);
+    dup2(fd,STDOUT_FILENO);
+    close(fd);
+  }
+  debug_setlevel(verbose ? 1 : -1);
+  pinSelf(0);
+
+  fprintf(out,"simusil microbench: %d reps, %d warmup, %ld cpus\n",reps,warmup,ncpu);
+  fprintf(out,"%-24s %3s %6s %-6s %10s %10s %10s %10s %10s\n",
+          "benchmark","thr","param","unit","min","p50","p90","p99","max");
+
+  benchLists();
+  benchRadar();
+  benchRadarBackEnd();
+  benchWakeup();
+  benchCannon();
+  benchGenerate();
+
+  writeJson(json);
+  if (baseline) bad=compareJson(baseline,tol);
+  fclose(out);
+  exit(bad ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,282 @@
+/*
+ * File: pipebench.cpp
+ *
+ * This file is part of the SimuSil library
+ *
+ * The hand-written C programs against their EngagementPipeline version
+ * (pipeline/, include/engagement.hpp), in two parts:
+ *   ordering    n engagements with random impact times are queued and
+ *               taken out in impact order: with list_insert() and a
+ *               comparator called through a pointer (5_EDF.c), with the
+ *               heap of EarliestDeadline and that same pointer, and with
+ *               the heap and its inlined comparator (DeadlineQueue)
+ *   engagement  every program runs -s seconds from the same snapshot
+ *               (-k, see checkpoint.h) with SIMUSIL_JOURNAL set and is
+ *               killed; the journal gives the missiles detected, fired,
+ *               intercepted and impacted, and the detect -> fire latency
+ *
+ * Compile: $ make bench/pipebench
+ *
+ * Usage:   $ ./bench/pipebench [-r reps] [-n runs] [-s seconds] [-k snapshot]
+ *          $ make pipebench   // snapshot of 40 missiles, then both parts
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include <stdio.h>    /* printf(3), fopen(3), fread(3)                 */
+#include <stdlib.h>   /* exit(3), atoi(3), setenv(3), drand48(3)       */
+#include <string.h>   /* memcmp(3), strcmp(3)                          */
+#include <stdint.h>   /* uint64_t                                      */
+#include <time.h>     /* clock_gettime(2), nanosleep(2)                */
+#include <unistd.h>   /* fork(2), execl(3), access(2), dup2(2)         */
+#include <fcntl.h>    /* open(2)                                       */
+#include <signal.h>   /* kill(2)                                       */
+#include <sys/wait.h> /* waitpid(2)                                    */
+#include <algorithm>  /* std::sort                                     */
+#include <vector>
+#include "engagement.hpp"
+
+using namespace simusil;
+
+#define JOURNAL_TMP "/tmp/pipebench.jrn"
+#define ORDER_OPS   16384   /* engagements ordered per sample         */
+#define MAX_ID      (1<<20) /* larger ids in a journal are corrupt    */
+
+int reps=20, runs=3, seconds=4;
+const char *snapshot=NULL;
+
+uint64_t nowNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (uint64_t)ts.tv_sec*1000000000ULL+ts.tv_nsec;
+}
+
+double median(std::vector<double> &s)
+{
+  std::sort(s.begin(),s.end());
+  return s.empty() ? 0 : s[s.size()/2];
+}
+
+
+/* ORDERING                                                            */
+
+/* the comparator of 5_EDF.c: cmp(a,b) is 1 if a goes after b          */
+int __attribute__((noinline)) cmpImpact(void *a, void *b)
+{
+  return later(((Engagement*)a)->impact,((Engagement*)b)->impact);
+}
+
+bool __attribute__((noinline)) laterPtr(const Engagement *a, const Engagement *b)
+{
+  return later(a->impact,b->impact);
+}
+
+typedef bool (*LaterFn)(const Engagement*, const Engagement*);
+typedef std::priority_queue<Engagement*,std::vector<Engagement*>,LaterFn>
+        PtrQueue;
+
+/* ns per engagement to queue all of them and take them out in order,
+ * ORDER_OPS engagements per sample                                    */
+double orderList(std::vector<Engagement> &e)
+{
+  List_ptr_t l=createList((char*)"Bench",(char*)"engagement",1);
+  size_t i, k, rounds=ORDER_OPS/e.size();
+  uint64_t t0=nowNs();
+
+  for (k=0; k<rounds; k++)
+  {
+    for (i=0; i<e.size(); i++) list_insert(&e[i],cmpImpact,e[i].id,l);
+    for (i=0; i<e.size(); i++) list_dequeue(l,0);
+  }
+  t0=nowNs()-t0;
+  destroyList(l,NULL);
+  return (double)t0/(rounds*e.size());
+}
+
+template <class Queue>
+double orderHeap(std::vector<Engagement> &e, Queue q)
+{
+  size_t i, k, rounds=ORDER_OPS/e.size();
+  uint64_t t0=nowNs();
+
+  for (k=0; k<rounds; k++)
+  {
+    for (i=0; i<e.size(); i++) q.push(&e[i]);
+    for (i=0; i<e.size(); i++) q.pop();
+  }
+  return (double)(nowNs()-t0)/(rounds*e.size());
+}
+
+void benchOrdering(void)
+{
+  static const int sizes[]={16,64,256,1024};
+  std::vector<double> s[3];
+  unsigned k;
+  int r, i;
+
+  printf("%-28s %6s %12s %12s %12s\n","ordering (ns/engagement)","n",
+         "list+cmp*","heap+cmp*","heap inline");
+  for (k=0; k<sizeof(sizes)/sizeof(sizes[0]); k++)
+  {
+    for (i=0; i<3; i++) s[i].clear();
+    for (r=0; r<reps; r++)
+    {
+      std::vector<Engagement> e(sizes[k]);
+      for (i=0; i<sizes[k]; i++)
+      {
+        e[i].id=i;
+        e[i].impact.tv_sec=(time_t)(drand48()*2);
+        e[i].impact.tv_nsec=(long)(drand48()*1e9);
+      }
+      s[0].push_back(orderList(e));
+      s[1].push_back(orderHeap(e,PtrQueue(laterPtr)));
+      s[2].push_back(orderHeap(e,DeadlineQueue()));
+    }
+    printf("%-28s %6d %12.1f %12.1f %12.1f\n","p50",sizes[k],
+           median(s[0]),median(s[1]),median(s[2]));
+  }
+}
+
+
+/* ENGAGEMENT                                                          */
+
+typedef struct{
+  uint64_t count[JOURNAL_NUM_EVENTS];
+  uint64_t corrupt;             /* records with impossible values      */
+  std::vector<double> latency;  /* detect -> fire, ms                 */
+}Run;
+
+/* events of the journal left by a killed program                     */
+int readJournal(const char *path, Run &run)
+{
+  std::vector<uint64_t> detect;
+  JournalHeader h;
+  JournalRecord r;
+  uint64_t n;
+  FILE *f;
+
+  if ((f=fopen(path,"rb")) == NULL) return -1;
+  if (fread(&h,sizeof(h),1,f) != 1 ||
+      memcmp(h.magic,JOURNAL_MAGIC,sizeof(h.magic)) != 0)
+  {
+    fclose(f);
+    return -1;
+  }
+  for (n=0; n<h.next && n<h.capacity && fread(&r,sizeof(r),1,f) == 1; n++)
+  {
+    if (r.event == JOURNAL_NONE) continue;  /* reserved, never written */
+    if (r.event >= JOURNAL_NUM_EVENTS || r.id >= MAX_ID)
+    {
+      run.corrupt++;
+      continue;
+    }
+    run.count[r.event]++;
+    if (r.id >= detect.size()) detect.resize(r.id+1,0);
+    if (r.event == JOURNAL_DETECT) detect[r.id]=r.t_ns;
+    if (r.event == JOURNAL_FIRE && detect[r.id] != 0)
+      run.latency.push_back((r.t_ns-detect[r.id])/1e6);
+  }
+  fclose(f);
+  return 0;
+}
+
+/* runs prog for the given seconds and reads its journal              */
+int runProgram(const char *prog, Run &run)
+{
+  struct timespec t={seconds,0};
+  pid_t pid;
+  int fd;
+
+  unlink(JOURNAL_TMP);
+  if ((pid=fork()) == 0)
+  {
+    if ((fd=open("/dev/null",O_WRONLY)) >= 0)
+    {
+      dup2(fd,STDOUT_FILENO);
+      dup2(fd,STDERR_FILENO);
+    }
+    setenv("SIMUSIL_JOURNAL",JOURNAL_TMP,1);
+    if (snapshot != NULL) setenv("SIMUSIL_SNAPSHOT",snapshot,1);
+    execl(prog,prog,(char*)NULL);
+    _exit(EXIT_FAILURE);
+  }
+  nanosleep(&t,NULL);
+  kill(pid,SIGKILL);  /* SIGINT may hang them inside destroyWorld     */
+  waitpid(pid,NULL,0);
+  return readJournal(JOURNAL_TMP,run);
+}
+
+void benchEngagement(void)
+{
+  static const char *progs[]={"./2_Serial","./pipeline/2_Serial",
+                              "./3_Parallel","./pipeline/3_Parallel",
+                              "./4_Mutex","./pipeline/4_Mutex",
+                              "./5_EDF","./pipeline/5_EDF"};
+  uint64_t det, hit;
+  unsigned k;
+  int i;
+
+  printf("\n%-28s %6s %8s %8s %8s %8s %12s %8s\n","engagement (per run)","runs",
+         "detect","fire","hit","impact","det->fire ms","corrupt");
+  for (k=0; k<sizeof(progs)/sizeof(progs[0]); k++)
+  {
+    Run run={};
+
+    if (access(progs[k],X_OK) != 0)
+    {
+      printf("%-28s (not built)\n",progs[k]);
+      continue;
+    }
+    for (i=0; i<runs; i++)
+      if (runProgram(progs[k],run) < 0)
+      {
+        printf("%-28s (no journal)\n",progs[k]);
+        break;
+      }
+    if (i < runs) continue;
+    det=run.count[JOURNAL_DETECT];
+    hit=run.count[JOURNAL_INTERCEPT];
+    printf("%-28s %6d %8.1f %8.1f %8.1f %8.1f %12.1f %8lu   hit rate %3.0f%%\n",
+           progs[k],runs,(double)det/runs,
+           (double)run.count[JOURNAL_FIRE]/runs,(double)hit/runs,
+           (double)run.count[JOURNAL_IMPACT]/runs,median(run.latency),
+           (unsigned long)run.corrupt,det ? 100.0*hit/det : 0.0);
+  }
+  unlink(JOURNAL_TMP);
+  printf("corrupt: records discarded over all runs. The double timer_delete\n"
+         "of destroyMissile() frees heap blocks of the program (README): the\n"
+         "C programs lose their Args_t, the pipeline keeps its Engagement\n"
+         "out of that bin (alignas(64)) and loses other blocks, so the two\n"
+         "sides do not run under the same corruption. Compare with care.\n");
+}
+
+
+void usage(char *prog)
+{
+  fprintf(stderr,"Usage: %s [-r reps] [-n runs] [-s seconds] [-k snapshot]\n",prog);
+  exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+  int i;
+
+  for (i=1; i<argc; i++)
+  {
+    if (strcmp(argv[i],"-r") == 0 && i+1 < argc) reps=atoi(argv[++i]);
+    else if (strcmp(argv[i],"-n") == 0 && i+1 < argc) runs=atoi(argv[++i]);
+    else if (strcmp(argv[i],"-s") == 0 && i+1 < argc) seconds=atoi(argv[++i]);
+    else if (strcmp(argv[i],"-k") == 0 && i+1 < argc) snapshot=argv[++i];
+    else usage(argv[0]);
+  }
+  if (reps < 1 || runs < 1 || seconds < 1) usage(argv[0]);
+
+  debug_setlevel(-1);
+  srand48(1);
+  benchOrdering();
+  benchEngagement();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*
+ * File: board.h
+ *
+ * This file is part of the SimuSil library
+ *
+ * Threat board shared between processes (POSIX shared memory).
+ * The World process publishes every missile seen by its Radar as a
+ * track and keeps its position up to date. Battery processes claim
+ * tracks with a compare-and-swap on an ownership word that holds the
+ * battery and a lease expiry, so a track is engaged by only one battery
+ * and a track claimed by a dead battery is free again when the lease
+ * expires. Batteries fire their cannons (owned by the World process)
+ * through a mailbox per cannon.
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#ifndef _BOARD_H_
+#define _BOARD_H_
+
+#include "simusil.h"
+
+#define BOARD_NAME        "/simusil_board"
+#define BOARD_TRACKS      1024  /* ring of tracks, > missiles in the sky */
+#define BOARD_MAX_CANNONS 64
+#define BOARD_LEASE_MS    2000  /* renewed while the cannon moves+fires  */
+
+/* tipos */
+typedef struct Board* Board_ptr_t;
+
+
+/* Prototipos */
+
+// SEGMENT //
+/*
+ * Function name: boardCreate
+ * Description:   creates (or replaces) the shared segment with ncannons
+ *                mailboxes; used by the World process
+ * Return value:  a pointer to the mapped Board, NULL on error
+ */
+Board_ptr_t boardCreate(const char *, int);
+
+/*
+ * Function name: boardAttach
+ * Description:   maps an existing Board; used by the battery processes
+ * Return value:  a pointer to the mapped Board, NULL on error
+ */
+Board_ptr_t boardAttach(const char *);
+
+/*
+ * Function name: boardDetach / boardDestroy
+ * Description:   unmaps the Board / unmaps and removes the segment
+ * Return value:  (none)
+ */
+void boardDetach(Board_ptr_t);
+void boardDestroy(Board_ptr_t, const char *);
+
+/*
+ * Function name: boardShutdown / boardIsShutdown
+ * Description:   asks every process to finish / checks that request
+ * Return value:  (none) / not 0 if shutting down
+ */
+void boardShutdown(Board_ptr_t);
+int boardIsShutdown(Board_ptr_t);
+int boardNumCannons(Board_ptr_t);
+// END SEGMENT //
+
+
+// TRACKS //
+/*
+ * Function name: boardPublish
+ * Description:   World side: adds a new active track at the given position
+ * Return value:  sequence number of the track
+ */
+long boardPublish(Board_ptr_t, Pos);
+
+/*
+ * Function name: boardUpdate
+ * Description:   World side: new state and position of a track
+ * Return value:  (none)
+ */
+void boardUpdate(Board_ptr_t, long, MissileState, Pos);
+
+/*
+ * Function name: boardClaim
+ * Description:   Battery side: takes the active, not yet fired track that
+ *                is closest to the ground and not leased by another
+ *                battery. The lease lasts BOARD_LEASE_MS, boardRenew()
+ *                extends it.
+ * Return value:  sequence number and position of the track, -1 if none
+ */
+long boardClaim(Board_ptr_t, int, Pos *);
+
+/*
+ * Function name: boardRenew
+ * Description:   Battery side: extends the lease of an owned track
+ * Return value:  1 if the track is still ours, 0 otherwise
+ */
+int boardRenew(Board_ptr_t, long, int);
+
+/*
+ * Function name: boardFired
+ * Description:   Battery side: the track has been shot, nobody else
+ *                will claim it, even after the lease expires. Only the
+ *                battery that owns the track can mark it (CAS on the
+ *                owner word)
+ * Return value:  1 if marked, 0 if the track is no longer ours
+ */
+int boardFired(Board_ptr_t, long, int);
+// END TRACKS //
+
+
+// CANNONS //
+/*
+ * Function name: boardCannonFire
+ * Description:   Battery side: asks the World process to move the cannon
+ *                to x and fire at the track seq of the battery; waits
+ *                until the shot is done, renewing the lease meanwhile
+ * Return value:  0 when fired, -1 if shutting down
+ */
+int boardCannonFire(Board_ptr_t, int, int, long, int);
+
+/*
+ * Function name: boardCannonNext / boardCannonDone
+ * Description:   World side: waits for the next order for a cannon and
+ *                reports that it has been carried out
+ * Return value:  target position, -1 if shutting down / (none)
+ */
+int boardCannonNext(Board_ptr_t, int);
+void boardCannonDone(Board_ptr_t, int);
+// END CANNONS //
+
+#endif /*_BOARD_H_*/
@@ -0,0 +1,81 @@
+/*
+ * File: checkpoint.h
+ *
+ * This file is part of the SimuSil library
+ *
+ * World checkpoint and restore. worldSave() writes the state of the
+ * simulation to a small binary file: the missiles in the sky (position,
+ * speed and time since launch), the position of the cannons, the world
+ * counters and the state of the random generator of the Bomber.
+ * worldLoad() creates a World and puts it back in that state, so a
+ * scenario with a crowded sky starts in milliseconds, and from the same
+ * state every time.
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <stdint.h>
+#include "simusil.h"
+
+#define CHECKPOINT_MAGIC   "SIMUCKPT"
+#define CHECKPOINT_VERSION 1
+
+/* tipos */
+typedef struct{
+  char     magic[8];
+  uint32_t version;
+  uint32_t nmissiles;  /* CheckpointMissile records after the header  */
+  uint32_t ncannons;   /* CheckpointCannon records after the missiles */
+  uint32_t missiles;   /* world counters: launched (next id),         */
+  uint32_t impacts;    /*   impacted and                              */
+  uint32_t interceptions; /* intercepted missiles                     */
+  uint16_t rand48[3];  /* drand48(3) state: Bomber rate and missiles  */
+  uint16_t reserved16;
+  uint64_t reserved[3];
+}CheckpointHeader;     /* 64 bytes                                     */
+
+typedef struct{
+  int64_t  age_ns;     /* time since launch when saved                 */
+  uint32_t id;
+  int32_t  x;
+  int32_t  y;          /* launch height                                */
+  int32_t  speed;      /* units per second                             */
+}CheckpointMissile;    /* 24 bytes                                     */
+
+typedef struct{
+  int32_t  pos;
+  uint32_t moves;      /* steps walked since created                   */
+}CheckpointCannon;     /* 8 bytes                                      */
+
+
+/* Prototipos */
+
+/*
+ * Function name: worldSave
+ * Description:   writes the state of the World to a file. Missiles that
+ *                have already hit the ground or been intercepted are not
+ *                saved; a missile with a shell on its way is saved as if
+ *                the shell had not been fired
+ * Return value:  number of missiles saved, -1 on error
+ */
+int worldSave(World_ptr_t, const char *);
+
+/*
+ * Function name: worldLoad
+ * Description:   creates a World like createWorld (name, cannons, debug
+ *                level) and restores the state saved in the file: the
+ *                missiles keep flying from where they were and are handed
+ *                again, in launch order, by radarWaitMissile(). The Bomber
+ *                is stopped, as after createWorld.
+ *                If path is NULL the environment variable SIMUSIL_SNAPSHOT
+ *                is used, and if it is not set the World starts empty.
+ * Return value:  a pointer to the allocated World object, NULL on error
+ */
+World_ptr_t worldLoad(const char *, char *, int, int);
+
+#endif /*_CHECKPOINT_H_*/
@@ -0,0 +1,378 @@
+/*
+ * File: engagement.hpp
+ *
+ * This file is part of the SimuSil library
+ *
+ * Header-only C++ version of the engagement loop of 2_Serial.c .. 5_EDF.c.
+ * EngagementPipeline<Detector,Estimator,Scheduler,Executor,Tracker> puts
+ * together five policies, chosen at compile time, over the simusil.h C API:
+ *
+ *   Detector   gets the next missile                 RadarWait
+ *   Estimator  reads it, and its impact time         OneReading, TwoReadings
+ *   Scheduler  gives the cannon to one engagement    Unscheduled, CannonMutex,
+ *                                                    EarliestDeadline
+ *   Executor   where every engagement runs           Serial, ThreadPerMissile
+ *   Tracker    follows it until intercepted/impacted Polling
+ *
+ * Between Scheduler::acquire() and Scheduler::release() the cannon is
+ * moved and fired, as in the C programs. Every call is resolved by the
+ * compiler, and so is the comparator of EarliestDeadline: no function
+ * pointers and no void* in the way. Each program of pipeline/ is one
+ * instantiation, e.g. the one of 4_Mutex.c:
+ *
+ *   typedef EngagementPipeline<RadarWait,OneReading,
+ *                              CannonMutex,ThreadPerMissile,Polling<> > Mutex_t;
+ *   int main(int argc, char *argv[]) { return Mutex_t::run("TRSM 2016"); }
+ *
+ * Compile: $ make pipeline/4_Mutex
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#ifndef _ENGAGEMENT_HPP_
+#define _ENGAGEMENT_HPP_
+
+#include <stdio.h>     /* printf(3)                                    */
+#include <stdlib.h>    /* exit(3), EXIT_SUCCESS, EXIT_FAILURE          */
+#include <signal.h>    /* signal(2), SIGINT, SIG_DFL                   */
+#include <time.h>      /* clock_gettime(2), clock_nanosleep(2)         */
+#include <pthread.h>   /* pthread stuff (_create,_cancel,_mutex)       */
+#include <semaphore.h> /* sem_init(3), sem_wait(3), sem_post(3)        */
+#include <queue>       /* std::priority_queue                          */
+#include <vector>
+extern "C" {
+#include "simusil.h"
+#include "journal.h"
+#include "checkpoint.h"
+}
+
+namespace simusil {
+
+/* one missile on its way through the pipeline (Args_t of the C code).
+ * destroyMissile() deletes the timer impact() already deleted, and that
+ * second timer_delete(2) frees whatever reused its memory [README].
+ * alignas(64) only mitigates it: with the glibc allocator an Engagement
+ * is no longer carved from the bin of those timers, so the corruption
+ * lands on someone else (the Args_t of the C code, the Elems of a List) */
+struct alignas(64) Engagement{
+  int id;
+  pthread_t thid;
+  Missile_ptr_t m;
+  Pos p;                   /* last reading                             */
+  struct timespec impact;  /* estimated by the Estimator, if it can    */
+  sem_t turn;              /* EarliestDeadline: posted when it's ours  */
+};
+
+/* the pieces of the World every stage may need                        */
+struct Battery{
+  World_ptr_t w;
+  Bomber_ptr_t b;
+  Radar_ptr_t r;
+  Cannon_ptr_t c;
+};
+
+static inline struct timespec addNs(struct timespec t, long ns)
+{
+  ns+=t.tv_nsec;
+  t.tv_sec+=ns/1000000000L;
+  t.tv_nsec=ns%1000000000L;
+  return t;
+}
+
+static inline bool later(const struct timespec &a, const struct timespec &b)
+{
+  return a.tv_sec != b.tv_sec ? a.tv_sec > b.tv_sec : a.tv_nsec > b.tv_nsec;
+}
+
+
+/* DETECTORS                                                          */
+
+/* radarWaitMissile(): every program so far                            */
+struct RadarWait{
+  static Missile_ptr_t detect(Battery &bt) { return radarWaitMissile(bt.r); }
+};
+
+
+/* ESTIMATORS: false if the missile is gone before we could aim        */
+
+/* 2_Serial .. 4_Mutex: one reading, no impact time                    */
+struct OneReading{
+  static bool estimate(Battery &bt, Engagement &e)
+  {
+    e.impact.tv_sec=e.impact.tv_nsec=0;
+    return radarReadMissile(bt.r,e.m,&e.p) == MISSILE_ACTIVE;
+  }
+};
+
+/* 5_EDF: two readings DeltaNs apart give the speed, so the impact time */
+template <long DeltaNs=10000000L>
+struct TwoReadings{
+  static bool estimate(Battery &bt, Engagement &e)
+  {
+    struct timespec t;
+    Pos p0;
+    long fall;
+
+    clock_gettime(CLOCK_MONOTONIC,&t);
+    if (radarReadMissile(bt.r,e.m,&p0) != MISSILE_ACTIVE) return false;
+    t=addNs(t,DeltaNs);
+    clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&t,NULL);
+    if (radarReadMissile(bt.r,e.m,&e.p) != MISSILE_ACTIVE) return false;
+    fall=p0.y-e.p.y;
+    e.impact=addNs(t,fall > 0 ? (long)((double)e.p.y/fall*DeltaNs) : 0);
+    return true;
+  }
+};
+
+
+/* SCHEDULERS: who has the cannon between acquire() and release()      */
+
+/* 2_Serial, 3_Parallel: nobody waits                                  */
+struct Unscheduled{
+  static void acquire(Engagement &) {}
+  static void release() {}
+};
+
+/* 4_Mutex: first come, first served                                   */
+struct CannonMutex{
+  static inline pthread_mutex_t mutex_canon=PTHREAD_MUTEX_INITIALIZER;
+
+  static void acquire(Engagement &) { pthread_mutex_lock(&mutex_canon); }
+  static void release() { pthread_mutex_unlock(&mutex_canon); }
+};
+
+/* 5_EDF: the waiting engagement with the earliest impact goes first   */
+struct ByImpact{
+  bool operator()(const Engagement *a, const Engagement *b) const
+  {
+    return later(a->impact,b->impact);
+  }
+};
+typedef std::priority_queue<Engagement*,std::vector<Engagement*>,ByImpact>
+        DeadlineQueue;
+
+struct EarliestDeadline{
+  static inline pthread_mutex_t mutex_lista=PTHREAD_MUTEX_INITIALIZER;
+  static inline DeadlineQueue waiting;
+  static inline bool busy=false;
+
+  static void acquire(Engagement &e)
+  {
+    pthread_mutex_lock(&mutex_lista);
+    if (!busy)
+    {
+      busy=true;
+      pthread_mutex_unlock(&mutex_lista);
+      return;
+    }
+    sem_init(&e.turn,0,0);
+    waiting.push(&e);
+    pthread_mutex_unlock(&mutex_lista);
+    sem_wait(&e.turn);       /* release() gave us the cannon          */
+    sem_destroy(&e.turn);
+  }
+
+  static void release()
+  {
+    Engagement *next=NULL;
+
+    pthread_mutex_lock(&mutex_lista);
+    if (waiting.empty()) busy=false;
+    else
+    {
+      next=waiting.top();
+      waiting.pop();
+    }
+    pthread_mutex_unlock(&mutex_lista);
+    if (next != NULL) sem_post(&next->turn);
+  }
+};
+
+
+/* EXECUTORS: run(e) where the program wants it                        */
+
+/* 2_Serial: in the thread that waits for the radar                    */
+struct Serial{
+  static void init() {}
+  template <void (*Run)(Engagement*)>
+  static void launch(Engagement *e) { Run(e); }
+  static void done(Engagement *) {}
+  static void shutdown() {}
+};
+
+/* 3_Parallel .. 5_EDF: a detached thread per missile, cancelled at exit */
+struct ThreadPerMissile{
+  static inline List_ptr_t l;  /* list of living threads              */
+  static inline pthread_attr_t attr;
+
+  static void init()
+  {
+    l=createList((char*)"Threads",(char*)"worker",2);
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr,PTHREAD_CREATE_DETACHED);
+  }
+
+  template <void (*Run)(Engagement*)>
+  static void *thread(void *arg)
+  {
+    Engagement *e=(Engagement*)arg;
+
+    list_enqueue(e,e->id,l);
+    Run(e);
+    pthread_exit(NULL);
+  }
+
+  template <void (*Run)(Engagement*)>
+  static void launch(Engagement *e)
+  {
+    pthread_create(&e->thid,&attr,thread<Run>,e);
+  }
+
+  static void done(Engagement *e) { list_remove(e,l); }
+
+  static void destroyWorker(void *arg)
+  {
+    Engagement *e=(Engagement*)arg;
+    pthread_cancel(e->thid);
+    delete e;
+  }
+
+  static void shutdown()
+  {
+    destroyList(l,destroyWorker);
+    pthread_attr_destroy(&attr);
+  }
+};
+
+
+/* TRACKERS                                                            */
+
+/* radarReadMissile() every RelaxNs until the missile is gone          */
+template <long RelaxNs=10000000L>
+struct Polling{
+  static void missing(Engagement &e)
+  {
+    printf("[%03d] Warning: missing missile!\n",e.id);
+    printf("[%03d] \tBetween Wait & Read:\n",e.id);
+    printf("[%03d] \t\tMissile impacted on ground, or\n",e.id);
+    printf("[%03d] \t\tMissile intercepted by a spurious previous shoot\n",e.id);
+    journalLog(JOURNAL_LOST,e.id,0,0,0);
+  }
+
+  static void track(Battery &bt, Engagement &e)
+  {
+    const struct timespec relaxTime={0,RelaxNs};
+    MissileState sm;
+
+    while ((sm=radarReadMissile(bt.r,e.m,&e.p)) == MISSILE_ACTIVE)
+      clock_nanosleep(CLOCK_MONOTONIC,0,&relaxTime,NULL);
+    switch (sm)
+    {
+      case MISSILE_INTERCEPTED:
+           printf("[%03d] ---> Interceptado en (%d,%d)\n",e.id,e.p.x,e.p.y);
+           journalLog(JOURNAL_INTERCEPT,e.id,0,e.p.x,e.p.y);
+           break;
+      case MISSILE_IMPACTED:
+           printf("[%03d] ---> Impacta en suelo (%d)\n",e.id,e.p.x);
+           journalLog(JOURNAL_IMPACT,e.id,0,e.p.x,e.p.y);
+           break;
+      case MISSILE_ERROR:
+      default:
+           printf("[%03d] ---> Error de seguimiento del misil\n",e.id);
+           journalLog(JOURNAL_LOST,e.id,0,e.p.x,e.p.y);
+    }
+  }
+};
+
+
+/*
+ * EngagementPipeline: the policies above, put together
+ */
+template <class Detector, class Estimator, class Scheduler,
+          class Executor, class Tracker>
+struct EngagementPipeline{
+  static inline Battery bt;
+
+  static void destroyer(int signum)
+  {
+    signal(SIGINT,SIG_DFL); /* restore default-TERM during destroyWorld */
+    Executor::shutdown();
+    journalClose(); /* after the workers: cancellation is deferred  */
+    destroyWorld(bt.w);
+    exit(EXIT_SUCCESS);
+  }
+
+  static void handler(int signum)
+  {
+    stopBombing(bt.b);
+    printf("Press ctrl+C to finish\n"); /* bad idea: printf in handler! */
+    signal(SIGINT,destroyer);
+  }
+
+  /* one missile: aim, move, fire and follow it                        */
+  static void engage(Engagement *e)
+  {
+    const struct timespec stallTime={0,1000000}; /* 1ms              */
+
+    if (!Estimator::estimate(bt,*e)) Tracker::missing(*e);
+    else
+    {
+      journalLog(JOURNAL_SCHEDULE,e->id,0,e->p.x,e->p.y);
+      Scheduler::acquire(*e);
+      printf("[%03d] ---> Moving cannon to position %d\n",e->id,e->p.x);
+      journalLog(JOURNAL_MOVE_START,e->id,0,e->p.x,e->p.y);
+      cannonMove(bt.c,e->p.x);
+      journalLog(JOURNAL_MOVE_END,e->id,0,e->p.x,e->p.y);
+      clock_nanosleep(CLOCK_MONOTONIC,0,&stallTime,NULL); /*espera antes*/
+      journalLog(JOURNAL_FIRE,e->id,0,e->p.x,e->p.y);
+      cannonFire(bt.c);
+      Scheduler::release();
+      Tracker::track(bt,*e);
+    }
+    Executor::done(e);
+    delete e;
+  }
+
+  /*
+   * Function name: run
+   * Description:   the main() of the C programs: creates (or restores, see
+   *                checkpoint.h) the World with one cannon, starts bombing
+   *                and engages every missile detected until ctrl+C twice
+   * Return value:  never returns
+   */
+  static int run(const char *name)
+  {
+    int missileCount=0;
+    Engagement *e;
+
+    debug_setlevel(1);
+
+    /* worldname,1 cannon,debug level 2; SIMUSIL_SNAPSHOT=file restores it */
+    if ((bt.w=worldLoad(NULL,(char*)name,1,2)) == NULL) exit(EXIT_FAILURE);
+    bt.b=getBomber(bt.w);
+    journalOpen(NULL,0); /* only if SIMUSIL_JOURNAL=file is set        */
+    bt.r=getRadar(bt.w);
+    bt.c=getCannon(bt.w,0); /* [0..n-1] cannon number 0 (first of one) */
+    Executor::init();
+
+    signal(SIGINT,handler);
+
+    printf("Press ctrl+C to stop bombing\n");
+    startBombing(bt.b);
+    while (1)
+    {
+      e=new Engagement();
+      e->id=missileCount++;
+      e->m=Detector::detect(bt);
+      journalLog(JOURNAL_DETECT,e->id,0,0,0);
+      Executor::template launch<engage>(e);
+    }
+    return 0; /* never reached!                                       */
+  }
+};
+
+} /* namespace simusil */
+
+#endif /*_ENGAGEMENT_HPP_*/
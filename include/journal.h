@@ -0,0 +1,109 @@
+/*
+ * File: journal.h
+ *
+ * This file is part of the SimuSil library
+ *
+ * Append-only binary journal of the simulation events seen by a program.
+ * The file is memory-mapped and holds a JournalHeader followed by fixed
+ * size JournalRecords. Any thread may call journalLog() without locks:
+ * a slot is reserved with an atomic increment and published by storing
+ * its event type last.
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#ifndef _JOURNAL_H_
+#define _JOURNAL_H_
+
+#include <stdint.h>
+
+#define JOURNAL_MAGIC   "SIMUJRNL"
+#define JOURNAL_VERSION 1
+#define JOURNAL_DEFAULT_RECORDS (1UL<<20) /* 32MB file, see journalOpen */
+
+/* tipos */
+typedef enum{
+  JOURNAL_NONE=0,      /* slot reserved but not yet written            */
+  JOURNAL_SPAWN,       /* missile generated: reserved, not emitted     */
+  JOURNAL_DETECT,      /* radarWaitMissile returned it                 */
+  JOURNAL_SCHEDULE,    /* worker queued/waiting for the cannon         */
+  JOURNAL_MOVE_START,  /* cannonMove called, x = target position       */
+  JOURNAL_MOVE_END,    /* cannonMove returned                          */
+  JOURNAL_FIRE,        /* cannonFire called                            */
+  JOURNAL_INTERCEPT,   /* radar reports MISSILE_INTERCEPTED            */
+  JOURNAL_IMPACT,      /* radar reports MISSILE_IMPACTED               */
+  JOURNAL_LOST,        /* missing missile or MISSILE_ERROR             */
+  JOURNAL_NUM_EVENTS
+}JournalEvent;
+
+typedef struct{
+  char     magic[8];
+  uint32_t version;
+  uint32_t recsize;    /* sizeof(JournalRecord)                        */
+  uint64_t capacity;   /* records available after the header           */
+  uint64_t next;       /* next free slot (may exceed capacity)         */
+  uint64_t start_ns;   /* CLOCK_MONOTONIC when the journal was opened  */
+  uint64_t reserved[3];
+}JournalHeader;         /* 64 bytes                                     */
+
+typedef struct{
+  uint64_t t_ns;       /* CLOCK_MONOTONIC, monotonic per missile       */
+  uint32_t id;         /* missile (worker) number                      */
+  uint16_t event;      /* JournalEvent, written last                   */
+  uint16_t cannon;
+  int32_t  x;
+  int32_t  y;
+  uint64_t reserved;
+}JournalRecord;        /* 32 bytes                                     */
+
+
+/* Prototipos */
+
+/*
+ * Function name: journalOpen
+ * Description:   creates (truncates) the journal file and maps room for
+ *                the given number of records (0 means the environment
+ *                variable SIMUSIL_JOURNAL_RECORDS, or the default).
+ *                If path is NULL the environment variable SIMUSIL_JOURNAL
+ *                is used, and if it is not set the journal stays closed
+ *                and journalLog() does nothing.
+ * Return value:  0 on success (or journal disabled), -1 on error
+ */
+int journalOpen(const char *, uint64_t);
+
+/*
+ * Function name: journalLog
+ * Description:   appends one event: event, missile id, cannon, position
+ *                Lock free; records beyond the capacity are dropped and
+ *                counted in journalDropped()
+ * Return value:  (none)
+ */
+void journalLog(JournalEvent, long, int, int, int);
+
+/*
+ * Function name: journalDropped
+ * Description:   number of events that did not fit in the journal
+ * Return value:  dropped events
+ */
+uint64_t journalDropped(void);
+
+/*
+ * Function name: journalClose
+ * Description:   stops the journal, flushes it and trims the unused slots
+ *                Events logged after it are dropped; the file stays mapped
+ *                for threads still logging, so call it after cancelling
+ *                them, right before exit. Reports the dropped events
+ * Return value:  (none)
+ */
+void journalClose(void);
+
+/*
+ * Function name: journalEventName
+ * Description:   printable name of an event type
+ * Return value:  static string
+ */
+const char *journalEventName(JournalEvent);
+
+#endif /*_JOURNAL_H_*/
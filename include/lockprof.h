@@ -0,0 +1,53 @@
+/*
+ * File: lockprof.h
+ *
+ * This file is part of the SimuSil library
+ *
+ * Lock contention profiler. Built with $ make LOCKPROF=1 the programs are
+ * linked with -Wl,--wrap for the pthread mutex, condition and semaphore
+ * calls, so every lock taken by the library (screenLock, the mutex of
+ * each List, the semaphore of each Cannon) and by the program itself
+ * goes through src/lockprof.c. Per lock it counts acquisitions and
+ * contended acquisitions, keeps log2 histograms of the wait and hold
+ * times and the call sites that waited the most. The report is written
+ * when destroyWorld() is called, to stderr or to the file named by the
+ * environment variable SIMUSIL_LOCKPROF.
+ * Without LOCKPROF=1 nothing is wrapped and nothing is measured.
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#ifndef _LOCKPROF_H_
+#define _LOCKPROF_H_
+
+#include <stdio.h>
+
+#define LOCKPROF_MAX_LOCKS 512  /* distinct lock addresses            */
+#define LOCKPROF_MAX_SITES 8    /* call sites kept per lock           */
+#define LOCKPROF_BUCKETS   32   /* log2(ns) buckets, last one >= 2s   */
+#define LOCKPROF_TOP       8    /* locks with histograms in the report */
+
+
+/* Prototipos */
+
+/*
+ * Function name: lockprofName
+ * Description:   gives a name to a lock (pthread_mutex_t* or sem_t*) for
+ *                the report. Global locks are named after their symbol
+ *                and List locks after the List, so it is seldom needed
+ * Return value:  (none)
+ */
+void lockprofName(void *, const char *);
+
+/*
+ * Function name: lockprofDump
+ * Description:   writes the report: a line per lock sorted by total wait
+ *                time, then the histograms and call sites of the top ones
+ *                Called by destroyWorld() when the program is profiled
+ * Return value:  (none)
+ */
+void lockprofDump(FILE *);
+
+#endif /*_LOCKPROF_H_*/
@@ -0,0 +1,101 @@
+/*
+ * File: sradar.h
+ *
+ * This file is part of the SimuSil library
+ *
+ * Sectorized view of the Radar. The x axis is split in K sectors; every
+ * sector has its own queue of new missiles, its own follow set and its
+ * own lock, and a refresher thread that polls the World Radar for the
+ * missiles of that sector only. Readers are served from the sector cache,
+ * so concurrent radar reads do not serialize on the single Radar mutex.
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#ifndef _SRADAR_H_
+#define _SRADAR_H_
+
+#include "simusil.h"
+
+#define SRADAR_DEFAULT_WIDTH  8000   /* x range seen in the bombing   */
+#define SRADAR_DEFAULT_PERIOD 2000000 /* ns between refreshes (2ms)   */
+
+/* tipos */
+typedef struct SRadar* SRadar_ptr_t;
+
+
+/* Prototipos */
+
+/*
+ * Function name: createSRadar
+ * Description:   splits [0,width) in nsectors sectors over the given Radar
+ *                and starts the feeder thread (radarWaitMissile) and one
+ *                refresher thread per sector, polling every period ns, or
+ *                less often when the sectors together would keep the
+ *                Radar lock more than a fourth of the time.
+ *                A width or period of 0 selects the default.
+ * Return value:  a pointer to the allocated SRadar object
+ */
+SRadar_ptr_t createSRadar(Radar_ptr_t, int, int, long, int); // radar, sectors, width, period, debug level
+
+/*
+ * Function name: destroySRadar
+ * Description:   stops the threads and frees every sector
+ *                Read counters are printed if the debug level allows it
+ *                The feeder is cancelled inside radarWaitMissile, which
+ *                leaves Radar.New locked: call it just before destroyWorld
+ * Return value:  (none)
+ */
+void destroySRadar(SRadar_ptr_t);
+
+/*
+ * Function name: sradarNumSectors / sradarSector
+ * Description:   number of sectors / sector that covers position x
+ * Return value:  as described
+ */
+int sradarNumSectors(SRadar_ptr_t);
+int sradarSector(SRadar_ptr_t, int);
+
+/*
+ * Function name: sradarWaitMissile
+ * Description:   waits until a new missile appears in the given sector
+ * Return value:  the new missile
+ */
+Missile_ptr_t sradarWaitMissile(SRadar_ptr_t, int);
+
+/*
+ * Function name: sradarPollMissile
+ * Description:   like sradarWaitMissile but returns inmediately
+ * Return value:  the new missile or NULL if there is none
+ */
+Missile_ptr_t sradarPollMissile(SRadar_ptr_t, int);
+
+/*
+ * Function name: sradarReadMissile
+ * Description:   reads the last known state and position of a missile
+ *                from the sector cache. *sector is the hint where to look
+ *                first and is updated if the missile was handed over to
+ *                another sector. Unknown missiles are read from the Radar.
+ *                Positions are at most one refresh period old (more
+ *                than period ns with many missiles in the sky).
+ * Return value:  state of the missile, like radarReadMissile()
+ */
+MissileState sradarReadMissile(SRadar_ptr_t, Missile_ptr_t, int *, Pos *);
+
+/*
+ * Function name: sradarBindThread
+ * Description:   pins the calling thread to the CPU that serves a sector
+ * Return value:  0 on success, an errno value otherwise
+ */
+int sradarBindThread(SRadar_ptr_t, int);
+
+/*
+ * Function name: sradarReads
+ * Description:   number of reads served so far by a sector
+ * Return value:  reads
+ */
+unsigned long sradarReads(SRadar_ptr_t, int);
+
+#endif /*_SRADAR_H_*/
@@ -0,0 +1,26 @@
+/*
+ * File: 2_Serial.cpp
+ *
+ * This file is part of the SimuSil library
+ *
+ * 2_Serial.c as an instantiation of EngagementPipeline (engagement.hpp):
+ * one missile at a time, in the main thread
+ *
+ * Compile: $ make pipeline/2_Serial
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include "engagement.hpp"
+
+using namespace simusil;
+
+typedef EngagementPipeline<RadarWait,OneReading,
+                           Unscheduled,Serial,Polling<> > Serial_t;
+
+int main(int argc, char *argv[])
+{
+  return Serial_t::run("TRSM 2016");
+}
@@ -0,0 +1,26 @@
+/*
+ * File: 3_Parallel.cpp
+ *
+ * This file is part of the SimuSil library
+ *
+ * 3_Parallel.c as an instantiation of EngagementPipeline (engagement.hpp):
+ * a thread per missile, nobody takes turns with the cannon
+ *
+ * Compile: $ make pipeline/3_Parallel
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include "engagement.hpp"
+
+using namespace simusil;
+
+typedef EngagementPipeline<RadarWait,OneReading,
+                           Unscheduled,ThreadPerMissile,Polling<> > Parallel_t;
+
+int main(int argc, char *argv[])
+{
+  return Parallel_t::run("TRSM 2016");
+}
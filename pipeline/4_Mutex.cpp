@@ -0,0 +1,26 @@
+/*
+ * File: 4_Mutex.cpp
+ *
+ * This file is part of the SimuSil library
+ *
+ * 4_Mutex.c as an instantiation of EngagementPipeline (engagement.hpp):
+ * a thread per missile, the cannon taken in arrival order
+ *
+ * Compile: $ make pipeline/4_Mutex
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include "engagement.hpp"
+
+using namespace simusil;
+
+typedef EngagementPipeline<RadarWait,OneReading,
+                           CannonMutex,ThreadPerMissile,Polling<> > Mutex_t;
+
+int main(int argc, char *argv[])
+{
+  return Mutex_t::run("TRSM 2016");
+}
@@ -0,0 +1,27 @@
+/*
+ * File: 5_EDF.cpp
+ *
+ * This file is part of the SimuSil library
+ *
+ * 5_EDF.c as an instantiation of EngagementPipeline (engagement.hpp):
+ * a thread per missile, the cannon given to the one that hits the
+ * ground first (impact time estimated from two readings 10ms apart)
+ *
+ * Compile: $ make pipeline/5_EDF
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include "engagement.hpp"
+
+using namespace simusil;
+
+typedef EngagementPipeline<RadarWait,TwoReadings<>,
+                           EarliestDeadline,ThreadPerMissile,Polling<> > EDF_t;
+
+int main(int argc, char *argv[])
+{
+  return EDF_t::run("TRSM 2016");
+}
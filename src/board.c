@@ -0,0 +1,315 @@
+/*
+ * File: board.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Compile: $ gcc -Wall -I./include -c src/board.c -o src/board.o
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include <stdio.h>     /* perror(3), fprintf(3)                       */
+#include <stdint.h>    /* uint64_t, uint32_t                          */
+#include <string.h>    /* memset(3), memcmp(3), memcpy(3)             */
+#include <errno.h>     /* errno, ETIMEDOUT, EINTR                     */
+#include <time.h>      /* clock_gettime(2)                            */
+#include <fcntl.h>     /* O_CREAT, O_RDWR                             */
+#include <unistd.h>    /* ftruncate(2), close(2)                      */
+#include <semaphore.h> /* sem_init(3), sem_post(3), sem_timedwait(3)  */
+#include <sys/mman.h>  /* shm_open(3), shm_unlink(3), mmap(2)         */
+#include "board.h"
+
+#define BOARD_MAGIC "SIMUBRD1"
+#define POLL_MS     100   /* how often blocked calls check shutdown   */
+#define OWNER_SHIFT 48
+#define EXPIRY_MASK ((1ULL<<OWNER_SHIFT)-1)
+
+/* one cache line per track                                           */
+typedef struct{
+  uint64_t seq;    /* seq+1 of the track in the slot, 0 = invalid     */
+  uint64_t claim;  /* (battery+1)<<48 | lease expiry (ms), 0 = free   */
+  uint64_t pos;    /* x<<32 | y, updated in one store                 */
+  uint32_t state;  /* MissileState                                    */
+  uint32_t fired;  /* battery+1 that shot it, 0 = not fired           */
+  uint64_t pad[4];
+} __attribute__((aligned(64))) Track;
+
+typedef struct{
+  sem_t req;       /* battery -> World: order in x                    */
+  sem_t done;      /* World -> battery: shot fired                    */
+  int32_t x;
+} __attribute__((aligned(64))) Mailbox;
+
+struct Board{
+  char magic[8];
+  int32_t ncannons;
+  int32_t shutdown;
+  uint64_t next;   /* next track sequence number                      */
+  Track t[BOARD_TRACKS];
+  Mailbox c[BOARD_MAX_CANNONS];
+};
+
+static uint64_t nowMs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts); /* system wide: same in every process */
+  return (uint64_t)ts.tv_sec*1000+ts.tv_nsec/1000000;
+}
+
+static uint64_t packPos(Pos p)
+{
+  return ((uint64_t)(uint32_t)p.x<<32) | (uint32_t)p.y;
+}
+
+static Pos unpackPos(uint64_t v)
+{
+  return (Pos){(int32_t)(v>>32),(int32_t)(v & 0xffffffff)};
+}
+
+/* sem_wait that gives up every POLL_MS to look at the shutdown flag
+ * and, if seq is a track (>= 0), to renew the lease of the battery   */
+static int waitOrShutdown(Board_ptr_t b, sem_t *s, long seq, int battery)
+{
+  struct timespec ts;
+
+  while (!boardIsShutdown(b))
+  {
+    if (seq >= 0) boardRenew(b,seq,battery);
+    clock_gettime(CLOCK_REALTIME,&ts);
+    ts.tv_nsec += POLL_MS*1000000L;
+    if (ts.tv_nsec >= 1000000000)
+    {
+      ts.tv_nsec -= 1000000000;
+      ++ts.tv_sec;
+    }
+    if (sem_timedwait(s,&ts) == 0) return 0;
+    if (errno != ETIMEDOUT && errno != EINTR) break;
+  }
+  return -1;
+}
+
+static Board_ptr_t mapBoard(const char *name, int flags)
+{
+  Board_ptr_t b;
+  int fd;
+
+  if ((fd=shm_open(name,flags,0600)) < 0)
+  {
+    perror("shm_open");
+    return NULL;
+  }
+  if ((flags & O_CREAT) && ftruncate(fd,sizeof(struct Board)) < 0)
+  {
+    perror("ftruncate");
+    close(fd);
+    return NULL;
+  }
+  b=mmap(NULL,sizeof(struct Board),PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+  close(fd);
+  if (b == MAP_FAILED)
+  {
+    perror("mmap");
+    return NULL;
+  }
+  return b;
+}
+
+Board_ptr_t boardCreate(const char *name, int ncannons)
+{
+  Board_ptr_t b;
+  int i;
+
+  if (ncannons < 1 || ncannons > BOARD_MAX_CANNONS) return NULL;
+  shm_unlink(name); /* stale segment of a crashed run                */
+  if ((b=mapBoard(name,O_CREAT|O_EXCL|O_RDWR)) == NULL) return NULL;
+  memset(b,0,sizeof(struct Board));
+  b->ncannons=ncannons;
+  for (i=0; i<ncannons; i++)
+  {
+    sem_init(&b->c[i].req,1,0);  /* pshared: used across processes   */
+    sem_init(&b->c[i].done,1,0);
+  }
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(b->magic,BOARD_MAGIC,sizeof(b->magic));
+  return b;
+}
+
+Board_ptr_t boardAttach(const char *name)
+{
+  Board_ptr_t b;
+
+  if ((b=mapBoard(name,O_RDWR)) == NULL) return NULL;
+  if (memcmp(b->magic,BOARD_MAGIC,sizeof(b->magic)) != 0)
+  {
+    fprintf(stderr,"boardAttach: %s is not a simusil board\n",name);
+    munmap(b,sizeof(struct Board));
+    return NULL;
+  }
+  return b;
+}
+
+void boardDetach(Board_ptr_t b)
+{
+  munmap(b,sizeof(struct Board));
+}
+
+void boardDestroy(Board_ptr_t b, const char *name)
+{
+  int i;
+
+  for (i=0; i<b->ncannons; i++)
+  {
+    sem_destroy(&b->c[i].req);
+    sem_destroy(&b->c[i].done);
+  }
+  boardDetach(b);
+  shm_unlink(name);
+}
+
+void boardShutdown(Board_ptr_t b)
+{
+  __atomic_store_n(&b->shutdown,1,__ATOMIC_RELEASE);
+}
+
+int boardIsShutdown(Board_ptr_t b)
+{
+  return __atomic_load_n(&b->shutdown,__ATOMIC_ACQUIRE);
+}
+
+int boardNumCannons(Board_ptr_t b)
+{
+  return b->ncannons;
+}
+
+long boardPublish(Board_ptr_t b, Pos p)
+{
+  uint64_t seq=__atomic_fetch_add(&b->next,1,__ATOMIC_RELAXED);
+  Track *t=&b->t[seq % BOARD_TRACKS];
+
+  if (t->seq != 0 && t->state == MISSILE_ACTIVE && !t->fired)
+    fprintf(stderr,"Board: track %lu dropped, BOARD_TRACKS too small\n",
+            (unsigned long)t->seq-1);
+  /* invalidate, fill, and publish the sequence number last           */
+  __atomic_store_n(&t->seq,0,__ATOMIC_RELEASE);
+  __atomic_store_n(&t->claim,0,__ATOMIC_RELAXED);
+  __atomic_store_n(&t->fired,0,__ATOMIC_RELAXED);
+  __atomic_store_n(&t->pos,packPos(p),__ATOMIC_RELAXED);
+  __atomic_store_n(&t->state,MISSILE_ACTIVE,__ATOMIC_RELAXED);
+  __atomic_store_n(&t->seq,seq+1,__ATOMIC_RELEASE);
+  return (long)seq;
+}
+
+void boardUpdate(Board_ptr_t b, long seq, MissileState st, Pos p)
+{
+  Track *t=&b->t[seq % BOARD_TRACKS];
+
+  if (__atomic_load_n(&t->seq,__ATOMIC_ACQUIRE) != (uint64_t)seq+1) return;
+  __atomic_store_n(&t->pos,packPos(p),__ATOMIC_RELAXED);
+  __atomic_store_n(&t->state,st,__ATOMIC_RELEASE);
+}
+
+long boardClaim(Board_ptr_t b, int battery, Pos *p)
+{
+  Track *t;
+  uint64_t now, c, seq, mine;
+  int i, best, besty;
+  Pos q;
+
+  while (1)
+  {
+    now=nowMs();
+    best=-1;
+    besty=0;
+    for (i=0; i<BOARD_TRACKS; i++)
+    {
+      t=&b->t[i];
+      if (__atomic_load_n(&t->seq,__ATOMIC_ACQUIRE) == 0) continue;
+      if (__atomic_load_n(&t->state,__ATOMIC_ACQUIRE) != MISSILE_ACTIVE) continue;
+      if (__atomic_load_n(&t->fired,__ATOMIC_ACQUIRE)) continue;
+      c=__atomic_load_n(&t->claim,__ATOMIC_ACQUIRE);
+      if (c != 0 && (c & EXPIRY_MASK) > now) continue;  /* leased    */
+      q=unpackPos(__atomic_load_n(&t->pos,__ATOMIC_RELAXED));
+      if (best < 0 || q.y < besty)
+      {
+        best=i;
+        besty=q.y;
+      }
+    }
+    if (best < 0) return -1;
+
+    /* CAS the ownership word; retry the scan if someone was faster   */
+    t=&b->t[best];
+    seq=__atomic_load_n(&t->seq,__ATOMIC_ACQUIRE);
+    c=__atomic_load_n(&t->claim,__ATOMIC_ACQUIRE);
+    if (seq == 0 || (c != 0 && (c & EXPIRY_MASK) > now)) continue;
+    mine=((uint64_t)(battery+1)<<OWNER_SHIFT) | (now+BOARD_LEASE_MS);
+    if (!__atomic_compare_exchange_n(&t->claim,&c,mine,0,
+                                     __ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE))
+      continue;
+    if (__atomic_load_n(&t->seq,__ATOMIC_ACQUIRE) != seq) continue; /* reused */
+    *p=unpackPos(__atomic_load_n(&t->pos,__ATOMIC_RELAXED));
+    return (long)seq-1;
+  }
+}
+
+int boardRenew(Board_ptr_t b, long seq, int battery)
+{
+  Track *t=&b->t[seq % BOARD_TRACKS];
+  uint64_t c, mine;
+
+  c=__atomic_load_n(&t->claim,__ATOMIC_ACQUIRE);
+  if ((c >> OWNER_SHIFT) != (uint64_t)battery+1) return 0;
+  mine=((uint64_t)(battery+1)<<OWNER_SHIFT) | (nowMs()+BOARD_LEASE_MS);
+  if (!__atomic_compare_exchange_n(&t->claim,&c,mine,0,
+                                   __ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE))
+    return 0;
+  return __atomic_load_n(&t->seq,__ATOMIC_ACQUIRE) == (uint64_t)seq+1;
+}
+
+int boardFired(Board_ptr_t b, long seq, int battery)
+{
+  Track *t=&b->t[seq % BOARD_TRACKS];
+  uint64_t c, mine;
+
+  if (__atomic_load_n(&t->seq,__ATOMIC_ACQUIRE) != (uint64_t)seq+1) return 0;
+  c=__atomic_load_n(&t->claim,__ATOMIC_ACQUIRE);
+  if ((c >> OWNER_SHIFT) != (uint64_t)battery+1) return 0;
+  /* a lease that never expires: nobody will claim it again           */
+  mine=((uint64_t)(battery+1)<<OWNER_SHIFT) | EXPIRY_MASK;
+  if (!__atomic_compare_exchange_n(&t->claim,&c,mine,0,
+                                   __ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE))
+    return 0;
+  if (__atomic_load_n(&t->seq,__ATOMIC_ACQUIRE) != (uint64_t)seq+1)
+  {
+    /* reused meanwhile: give the new track its claim back            */
+    __atomic_compare_exchange_n(&t->claim,&mine,c,0,
+                                __ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE);
+    return 0;
+  }
+  __atomic_store_n(&t->fired,battery+1,__ATOMIC_RELEASE);
+  return 1;
+}
+
+int boardCannonFire(Board_ptr_t b, int cannon, int x, long seq, int battery)
+{
+  Mailbox *m=&b->c[cannon];
+
+  m->x=x;
+  sem_post(&m->req);   /* sem_post/sem_wait order the write of x     */
+  return waitOrShutdown(b,&m->done,seq,battery);
+}
+
+int boardCannonNext(Board_ptr_t b, int cannon)
+{
+  Mailbox *m=&b->c[cannon];
+
+  if (waitOrShutdown(b,&m->req,-1,0) < 0) return -1;
+  return m->x;
+}
+
+void boardCannonDone(Board_ptr_t b, int cannon)
+{
+  sem_post(&b->c[cannon].done);
+}
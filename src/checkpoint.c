@@ -0,0 +1,362 @@
+/*
+ * File: checkpoint.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Compile: $ gcc -Wall -I./include -c src/checkpoint.c -o src/checkpoint.o
+ *
+ * World, Radar, Cannon and Missile are private to libsimusil.a; the Lib*
+ * structs below mirror the fields used here, as laid out in the library
+ * this was written against. Nothing checks that at compile time: at run
+ * time layoutOk() compares the World with the public getters before
+ * anything is read or written, and every missile found must point back
+ * to its World (m->w).
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include <stdio.h>    /* fopen(3), fread(3), fwrite(3), perror(3)     */
+#include <stdlib.h>   /* getenv(3), malloc(3), realloc(3), seed48(3)  */
+#include <string.h>   /* memcmp(3), memcpy(3), memset(3)              */
+#include <time.h>     /* clock_gettime(2), timer_settime(2)           */
+#include <signal.h>   /* struct sigevent                              */
+#include <pthread.h>  /* pthread_mutex_t                              */
+#include <sys/stat.h> /* fstat(2)                                     */
+#include "checkpoint.h"
+
+#define WORLD_LISTS 80  /* missiles of the World hashed by x          */
+#define WORLD_WIDTH 8000 /* generateMissile: x in [0,8000)            */
+
+/* not in simusil.h: the function the Bomber calls for every missile,
+ * and the traversal of a List (stops when cond returns not 0)        */
+void generateMissile(World_ptr_t);
+void *list_elem_cond(int(*)(void*,void*), void *, List_ptr_t);
+
+/* private layouts of libsimusil.a (world.o radar.o cannon.o missile.o) */
+struct LibWorld{
+  int missiles;        /* launched, also the id of the next one        */
+  int impacts;
+  int interceptions;
+  List_ptr_t lists[WORLD_LISTS]; /* missiles in the sky, by x%80      */
+  Radar_ptr_t radar;
+  Bomber_ptr_t bomber;
+  int ncannons;
+  Cannon_ptr_t *cannons;
+  pthread_mutex_t mutex; /* counters                                  */
+};
+
+struct LibRadar{
+  List_ptr_t New;      /* not yet returned by radarWaitMissile         */
+  List_ptr_t Follow;
+};
+
+struct LibCannon{
+  int id;
+  int moves;
+  int pos;
+  int step;
+};
+
+struct LibMissile{
+  long id;
+  int state;           /* MissileState                                 */
+  int x;
+  int y;               /* launch height                                */
+  int speed;
+  struct timespec t0;  /* launch time, CLOCK_MONOTONIC                 */
+  char unused[0x50-0x28];
+  timer_t timer;       /* impact, TIMER_ABSTIME                        */
+  struct sigevent sev;
+  struct itimerspec its;
+  World_ptr_t w;
+};
+
+/* missiles gathered by a List traversal                             */
+typedef struct{
+  World_ptr_t w;
+  struct timespec now;
+  CheckpointMissile *m;
+  int n, max;
+  int bad;
+} Sky;
+
+/* missile searched by id                                             */
+typedef struct{
+  long id;
+  struct LibMissile *m;
+} Find;
+
+
+static int64_t diff_ns(struct timespec a, struct timespec b)
+{
+  return (int64_t)(a.tv_sec-b.tv_sec)*1000000000LL+(a.tv_nsec-b.tv_nsec);
+}
+
+static struct timespec add_ns(struct timespec t, int64_t ns)
+{
+  ns+=t.tv_nsec;
+  t.tv_sec+=ns/1000000000LL;
+  t.tv_nsec=ns%1000000000LL;
+  if (t.tv_nsec < 0)
+  {
+    t.tv_sec--;
+    t.tv_nsec+=1000000000LL;
+  }
+  return t;
+}
+
+/* the World we got is the one described by the Lib* structs          */
+static int layoutOk(World_ptr_t w)
+{
+  struct LibWorld *W=(struct LibWorld*)w;
+  int i;
+
+  if (W->radar != getRadar(w) || W->bomber != getBomber(w) ||
+      W->ncannons != getNumCannons(w))
+    return 0;
+  for (i=0; i<W->ncannons; i++)
+    if (W->cannons[i] != getCannon(w,i) ||
+        ((struct LibCannon*)W->cannons[i])->id != i)
+      return 0;
+  return 1;
+}
+
+/* List traversal: copies the missiles still flying, never stops       */
+static int gather(void *obj, void *arg)
+{
+  struct LibMissile *m=obj;
+  Sky *sky=arg;
+
+  if (m->w != sky->w)
+  {
+    sky->bad=1;
+    return 1;
+  }
+  if (m->state != MISSILE_ACTIVE) return 0;
+  if (sky->n == sky->max)
+  {
+    sky->max=sky->max ? 2*sky->max : 64;
+    sky->m=realloc(sky->m,sky->max*sizeof(CheckpointMissile));
+  }
+  sky->m[sky->n++]=(CheckpointMissile){diff_ns(sky->now,m->t0),
+                                       (uint32_t)m->id,m->x,m->y,m->speed};
+  return 0;
+}
+
+static int byId(void *obj, void *arg)
+{
+  Find *f=arg;
+
+  if (((struct LibMissile*)obj)->id != f->id) return 0;
+  f->m=obj;
+  return 1;
+}
+
+
+int worldSave(World_ptr_t w, const char *path)
+{
+  struct LibWorld *W=(struct LibWorld*)w;
+  struct LibRadar *R=(struct LibRadar*)getRadar(w);
+  CheckpointHeader hdr;
+  CheckpointCannon c;
+  unsigned short seed[3]={0,0,0}, *old;
+  Sky sky;
+  FILE *f;
+  int i;
+
+  if (!layoutOk(w))
+  {
+    fprintf(stderr,"worldSave: unknown libsimusil.a layout\n");
+    return -1;
+  }
+  memset(&sky,0,sizeof(sky));
+  sky.w=w;
+  clock_gettime(CLOCK_MONOTONIC,&sky.now);
+  /* launch order: the followed ones were detected before the new ones */
+  list_elem_cond(gather,&sky,R->Follow);
+  list_elem_cond(gather,&sky,R->New);
+  if (sky.bad)
+  {
+    fprintf(stderr,"worldSave: unknown libsimusil.a layout\n");
+    free(sky.m);
+    return -1;
+  }
+
+  memset(&hdr,0,sizeof(hdr));
+  memcpy(hdr.magic,CHECKPOINT_MAGIC,sizeof(hdr.magic));
+  hdr.version=CHECKPOINT_VERSION;
+  hdr.nmissiles=sky.n;
+  hdr.ncannons=W->ncannons;
+  pthread_mutex_lock(&W->mutex);
+  hdr.missiles=W->missiles;
+  hdr.impacts=W->impacts;
+  hdr.interceptions=W->interceptions;
+  pthread_mutex_unlock(&W->mutex);
+  old=seed48(seed);    /* read the state and put it back              */
+  memcpy(hdr.rand48,old,sizeof(hdr.rand48));
+  memcpy(seed,old,sizeof(seed));
+  seed48(seed);
+
+  if ((f=fopen(path,"w")) == NULL)
+  {
+    perror("worldSave: fopen");
+    free(sky.m);
+    return -1;
+  }
+  fwrite(&hdr,sizeof(hdr),1,f);
+  fwrite(sky.m,sizeof(CheckpointMissile),sky.n,f);
+  for (i=0; i<W->ncannons; i++)
+  {
+    c.pos=((struct LibCannon*)W->cannons[i])->pos;
+    c.moves=((struct LibCannon*)W->cannons[i])->moves;
+    fwrite(&c,sizeof(c),1,f);
+  }
+  free(sky.m);
+  if (fclose(f) != 0)
+  {
+    perror("worldSave: fclose");
+    return -1;
+  }
+  return hdr.nmissiles;
+}
+
+/* a missile that could not be restored leaves the sky: out of the
+ * Radar and of every World list, impact disarmed. Its memory is lost  */
+static void dropMissile(struct LibWorld *W, struct LibRadar *R, struct LibMissile *m)
+{
+  struct itimerspec off;
+  int i;
+
+  list_remove(m,R->New);
+  for (i=0; i<WORLD_LISTS; i++) list_remove(m,W->lists[i]);
+  if (m->w == (World_ptr_t)W)   /* timer only if the layout is right   */
+  {
+    memset(&off,0,sizeof(off));
+    timer_settime(m->timer,0,&off,NULL);
+  }
+}
+
+/* a new missile moved to the saved position, speed and launch time    */
+static int restoreMissile(World_ptr_t w, CheckpointMissile *rec, struct timespec now)
+{
+  struct LibWorld *W=(struct LibWorld*)w;
+  struct LibRadar *R=(struct LibRadar*)W->radar;
+  struct LibMissile *m;
+  Find find={rec->id,NULL};
+
+  /* from the file: x indexes W->lists, y/speed give the impact time  */
+  if (rec->x < 0 || rec->x >= WORLD_WIDTH || rec->y <= 0 || rec->speed <= 0)
+    return -1;
+  pthread_mutex_lock(&W->mutex);
+  W->missiles=rec->id;   /* generateMissile takes it as its id        */
+  pthread_mutex_unlock(&W->mutex);
+  generateMissile(w);
+  list_elem_cond(byId,&find,R->New);
+  if ((m=find.m) == NULL) return -1;
+  if (m->w != w)
+  {
+    dropMissile(W,R,m);
+    return -1;
+  }
+
+  list_remove(m,W->lists[m->x%WORLD_LISTS]);
+  m->x=rec->x;
+  m->y=rec->y;
+  m->speed=rec->speed;
+  m->t0=add_ns(now,-rec->age_ns);
+  memset(&m->its,0,sizeof(m->its));
+  m->its.it_value=add_ns(m->t0,(int64_t)(1e9*rec->y/rec->speed));
+  /* in the sky before the impact is armed: it may be already due      */
+  list_enqueue(m,m->id,W->lists[m->x%WORLD_LISTS]);
+  if (timer_settime(m->timer,TIMER_ABSTIME,&m->its,NULL) < 0)
+  {
+    perror("worldLoad: timer_settime");
+    dropMissile(W,R,m);
+    return -1;
+  }
+  return 0;
+}
+
+World_ptr_t worldLoad(const char *path, char *name, int ncannons, int debug)
+{
+  CheckpointHeader hdr;
+  CheckpointMissile *rec=NULL;
+  CheckpointCannon c;
+  struct LibWorld *W;
+  struct LibCannon *C;
+  struct timespec now;
+  struct stat st;
+  unsigned short seed[3];
+  World_ptr_t w;
+  FILE *f;
+  int level, i;
+
+  if (path == NULL) path=getenv("SIMUSIL_SNAPSHOT");
+  if (path == NULL) return createWorld(name,ncannons,debug);
+
+  if ((f=fopen(path,"r")) == NULL)
+  {
+    perror("worldLoad: fopen");
+    return NULL;
+  }
+  /* never more records than the file holds: nmissiles is not trusted */
+  if (fstat(fileno(f),&st) < 0 || (size_t)st.st_size < sizeof(hdr) ||
+      fread(&hdr,sizeof(hdr),1,f) != 1 ||
+      memcmp(hdr.magic,CHECKPOINT_MAGIC,sizeof(hdr.magic)) != 0 ||
+      hdr.version != CHECKPOINT_VERSION ||
+      hdr.nmissiles > ((size_t)st.st_size-sizeof(hdr))/sizeof(CheckpointMissile) ||
+      (rec=malloc(((size_t)hdr.nmissiles+1)*sizeof(CheckpointMissile))) == NULL ||
+      fread(rec,sizeof(CheckpointMissile),hdr.nmissiles,f) != hdr.nmissiles)
+  {
+    fprintf(stderr,"worldLoad: %s is not a SimuSil checkpoint\n",path);
+    free(rec);
+    fclose(f);
+    return NULL;
+  }
+
+  w=createWorld(name,ncannons,debug);
+  W=(struct LibWorld*)w;
+  if (!layoutOk(w))
+  {
+    fprintf(stderr,"worldLoad: unknown libsimusil.a layout\n");
+    destroyWorld(w);
+    free(rec);
+    fclose(f);
+    return NULL;
+  }
+
+  /* cannons: those of the file that the new World also has           */
+  for (i=0; i<hdr.ncannons && fread(&c,sizeof(c),1,f) == 1; i++)
+    if (i < W->ncannons)
+    {
+      C=(struct LibCannon*)W->cannons[i];
+      C->pos=c.pos;
+      C->moves=c.moves;
+    }
+  fclose(f);
+
+  /* missiles already due hit the ground now and count as impacts     */
+  pthread_mutex_lock(&W->mutex);
+  W->impacts=hdr.impacts;
+  W->interceptions=hdr.interceptions;
+  pthread_mutex_unlock(&W->mutex);
+
+  /* missiles: generateMissile would print the random ones             */
+  level=debug_getlevel();
+  debug_setlevel(-1);
+  clock_gettime(CLOCK_MONOTONIC,&now);
+  for (i=0; i<hdr.nmissiles; i++)
+    if (restoreMissile(w,&rec[i],now) < 0)
+      fprintf(stderr,"worldLoad: missile %u not restored\n",rec[i].id);
+  debug_setlevel(level);
+  free(rec);
+
+  pthread_mutex_lock(&W->mutex);
+  W->missiles=hdr.missiles;
+  pthread_mutex_unlock(&W->mutex);
+  memcpy(seed,hdr.rand48,sizeof(seed));
+  seed48(seed);
+  return w;
+}
@@ -0,0 +1,138 @@
+/*
+ * File: journal.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Compile: $ gcc -Wall -I./include -c src/journal.c -o src/journal.o
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include <stdio.h>    /* perror(3), fprintf(3)                        */
+#include <stdlib.h>   /* getenv(3), strtoull(3)                       */
+#include <string.h>   /* memcpy(3), memset(3)                         */
+#include <time.h>     /* clock_gettime(2)                             */
+#include <fcntl.h>    /* open(2)                                      */
+#include <unistd.h>   /* ftruncate(2), close(2)                       */
+#include <sys/mman.h> /* mmap(2), msync(2)                             */
+#include "journal.h"
+
+/* one journal per process; hdr is read and cleared atomically, the
+ * mapping stays in place until the process exits                     */
+static JournalHeader *hdr=NULL;
+static size_t mapsize=0;
+static int fd=-1;
+static uint64_t dropped=0;
+
+static const char *names[JOURNAL_NUM_EVENTS]={
+  "none","spawn","detect","schedule","move_start","move_end",
+  "fire","intercept","impact","lost"
+};
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (uint64_t)ts.tv_sec*1000000000ULL+ts.tv_nsec;
+}
+
+int journalOpen(const char *path, uint64_t nrecords)
+{
+  JournalHeader *h;
+  char *env;
+
+  if (path == NULL) path=getenv("SIMUSIL_JOURNAL");
+  if (path == NULL || hdr != NULL) return 0;
+  if (nrecords == 0 && (env=getenv("SIMUSIL_JOURNAL_RECORDS")) != NULL)
+    nrecords=strtoull(env,NULL,0);
+  if (nrecords == 0) nrecords=JOURNAL_DEFAULT_RECORDS;
+
+  fd=open(path,O_RDWR|O_CREAT|O_TRUNC,0644);
+  if (fd < 0)
+  {
+    perror("journalOpen: open");
+    return -1;
+  }
+  mapsize=sizeof(JournalHeader)+nrecords*sizeof(JournalRecord);
+  if (ftruncate(fd,mapsize) < 0)
+  {
+    perror("journalOpen: ftruncate");
+    close(fd);
+    fd=-1;
+    return -1;
+  }
+  h=mmap(NULL,mapsize,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+  if (h == MAP_FAILED)
+  {
+    perror("journalOpen: mmap");
+    close(fd);
+    fd=-1;
+    return -1;
+  }
+  memset(h,0,sizeof(JournalHeader));
+  memcpy(h->magic,JOURNAL_MAGIC,sizeof(h->magic));
+  h->version=JOURNAL_VERSION;
+  h->recsize=sizeof(JournalRecord);
+  h->capacity=nrecords;
+  h->start_ns=now_ns();
+  __atomic_store_n(&hdr,h,__ATOMIC_RELEASE);
+  return 0;
+}
+
+void journalLog(JournalEvent ev, long id, int cannon, int x, int y)
+{
+  JournalHeader *h=__atomic_load_n(&hdr,__ATOMIC_ACQUIRE);
+  JournalRecord *r;
+  uint64_t slot;
+
+  if (h == NULL) return;
+  slot=__atomic_fetch_add(&h->next,1,__ATOMIC_RELAXED);
+  if (slot >= __atomic_load_n(&h->capacity,__ATOMIC_ACQUIRE))
+  {
+    __atomic_fetch_add(&dropped,1,__ATOMIC_RELAXED);
+    return;
+  }
+  r=(JournalRecord*)(h+1)+slot;
+  r->t_ns=now_ns();
+  r->id=(uint32_t)id;
+  r->cannon=(uint16_t)cannon;
+  r->x=x;
+  r->y=y;
+  /* publish: readers skip slots whose event is still JOURNAL_NONE     */
+  __atomic_store_n(&r->event,(uint16_t)ev,__ATOMIC_RELEASE);
+}
+
+uint64_t journalDropped(void)
+{
+  return __atomic_load_n(&dropped,__ATOMIC_RELAXED);
+}
+
+void journalClose(void)
+{
+  JournalHeader *h=__atomic_exchange_n(&hdr,NULL,__ATOMIC_ACQ_REL);
+  uint64_t used;
+
+  if (h == NULL) return;
+  /* threads still logging now get a slot past the end and drop it:
+   * only [0,used) is kept, and the mapping is never unmapped under
+   * them (the process is about to exit anyway)                       */
+  used=__atomic_fetch_add(&h->next,h->capacity,__ATOMIC_ACQ_REL);
+  if (used > h->capacity) used=h->capacity;
+  __atomic_store_n(&h->capacity,used,__ATOMIC_RELEASE);
+  __atomic_store_n(&h->next,used,__ATOMIC_RELEASE);
+  msync(h,mapsize,MS_SYNC);
+  if (ftruncate(fd,sizeof(JournalHeader)+used*sizeof(JournalRecord)) < 0)
+    perror("journalClose: ftruncate");
+  close(fd);
+  fd=-1;
+  if (journalDropped() > 0)
+    fprintf(stderr,"journal: %llu events dropped (SIMUSIL_JOURNAL_RECORDS)\n",
+            (unsigned long long)journalDropped());
+}
+
+const char *journalEventName(JournalEvent ev)
+{
+  return (ev < JOURNAL_NUM_EVENTS) ? names[ev] : "unknown";
+}
@@ -0,0 +1,526 @@
+/*
+ * File: lockprof.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Compile: $ gcc -Wall -I./include -c src/lockprof.c -o src/lockprof.o
+ *
+ * The __wrap_ functions are only reached when the program is linked with
+ * -Wl,--wrap=<symbol> for every symbol in LOCKPROF_WRAP (Makefile). The
+ * __real_ references are weak so this object links into any program.
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#define _GNU_SOURCE   /* dladdr(3)                                    */
+#include <stdio.h>    /* fprintf(3), snprintf(3), fopen(3)            */
+#include <stdlib.h>   /* getenv(3), qsort(3)                          */
+#include <string.h>   /* strncpy(3), strcmp(3), strrchr(3)            */
+#include <stdint.h>   /* uint64_t, uintptr_t                          */
+#include <errno.h>    /* EBUSY, EAGAIN                                */
+#include <time.h>     /* clock_gettime(2)                             */
+#include <dlfcn.h>    /* dladdr(3)                                    */
+#include <pthread.h>
+#include <semaphore.h>
+#include "simusil.h"
+#include "lockprof.h"
+
+#define LOCKPROF_MAX_HELD 16    /* locks held at once by a thread     */
+#define NAME_LEN 48
+
+enum{ LOCK_MUTEX, LOCK_SEM };
+
+typedef struct{
+  void *pc;               /* return address into the caller           */
+  uint64_t acq;
+  uint64_t contended;
+  uint64_t wait_ns;
+} Site;
+
+typedef struct{
+  void *addr;             /* key, NULL = free slot                    */
+  int kind;
+  uint64_t seq;           /* order of first use                       */
+  void *first_pc;         /* init (or first lock) call site           */
+  char name[NAME_LEN];
+  uint64_t acq, contended;
+  uint64_t wait_ns, wait_max;
+  uint64_t holds, hold_ns, hold_max;
+  uint64_t wait_hist[LOCKPROF_BUCKETS];
+  uint64_t hold_hist[LOCKPROF_BUCKETS];
+  Site site[LOCKPROF_MAX_SITES];
+  uint64_t other_acq, other_wait_ns; /* sites that did not fit        */
+} Lock;
+
+typedef struct{
+  Lock *l;
+  uint64_t t0;
+} Held;
+
+/* one table per process, never freed                                */
+static Lock table[LOCKPROF_MAX_LOCKS];
+static uint64_t nextSeq=0;
+static __thread Held held[LOCKPROF_MAX_HELD];
+static __thread int nheld=0;
+static __thread char pending[NAME_LEN]; /* name for the next init     */
+
+/* the real calls, resolved by the linker only under --wrap           */
+extern int __real_pthread_mutex_init(pthread_mutex_t *, const pthread_mutexattr_t *) __attribute__((weak));
+extern int __real_pthread_mutex_lock(pthread_mutex_t *) __attribute__((weak));
+extern int __real_pthread_mutex_trylock(pthread_mutex_t *) __attribute__((weak));
+extern int __real_pthread_mutex_unlock(pthread_mutex_t *) __attribute__((weak));
+extern int __real_pthread_cond_wait(pthread_cond_t *, pthread_mutex_t *) __attribute__((weak));
+extern int __real_pthread_cond_timedwait(pthread_cond_t *, pthread_mutex_t *, const struct timespec *) __attribute__((weak));
+extern int __real_sem_init(sem_t *, int, unsigned int) __attribute__((weak));
+extern int __real_sem_wait(sem_t *) __attribute__((weak));
+extern int __real_sem_trywait(sem_t *) __attribute__((weak));
+extern int __real_sem_timedwait(sem_t *, const struct timespec *) __attribute__((weak));
+extern int __real_sem_post(sem_t *) __attribute__((weak));
+extern List_ptr_t __real_createList(char *, char *, int) __attribute__((weak));
+extern void __real_destroyWorld(World_ptr_t) __attribute__((weak));
+
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (uint64_t)ts.tv_sec*1000000000ULL+ts.tv_nsec;
+}
+
+static int bucket(uint64_t ns)
+{
+  int b;
+
+  if (ns < 2) return 0;
+  b=63-__builtin_clzll(ns);
+  return (b < LOCKPROF_BUCKETS) ? b : LOCKPROF_BUCKETS-1;
+}
+
+static void atomicMax(uint64_t *p, uint64_t v)
+{
+  uint64_t old=__atomic_load_n(p,__ATOMIC_RELAXED);
+
+  while (v > old &&
+         !__atomic_compare_exchange_n(p,&old,v,1,__ATOMIC_RELAXED,__ATOMIC_RELAXED));
+}
+
+/* entry of a lock, created on first use; NULL if the table is full    */
+static Lock *lookup(void *addr, int kind, void *pc)
+{
+  uintptr_t h=((uintptr_t)addr>>4)*0x9E3779B97F4A7C15ULL;
+  void *empty;
+  Lock *l;
+  int i;
+
+  for (i=0; i<LOCKPROF_MAX_LOCKS; i++)
+  {
+    l=&table[(h+i)%LOCKPROF_MAX_LOCKS];
+    if (__atomic_load_n(&l->addr,__ATOMIC_ACQUIRE) == addr) return l;
+    empty=NULL;
+    if (l->addr == NULL &&
+        __atomic_compare_exchange_n(&l->addr,&empty,addr,0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE))
+    {
+      l->kind=kind;
+      l->seq=__atomic_fetch_add(&nextSeq,1,__ATOMIC_RELAXED);
+      l->first_pc=pc;
+      return l;
+    }
+    if (empty == addr) return l;  /* inserted meanwhile by another one */
+  }
+  return NULL;
+}
+
+static void countSite(Lock *l, void *pc, int contended, uint64_t wait)
+{
+  void *empty;
+  Site *s;
+  int i;
+
+  for (i=0; i<LOCKPROF_MAX_SITES; i++)
+  {
+    s=&l->site[i];
+    empty=NULL;
+    if (__atomic_load_n(&s->pc,__ATOMIC_RELAXED) == pc ||
+        (s->pc == NULL &&
+         (__atomic_compare_exchange_n(&s->pc,&empty,pc,0,__ATOMIC_RELAXED,__ATOMIC_RELAXED) ||
+          empty == pc)))
+    {
+      __atomic_fetch_add(&s->acq,1,__ATOMIC_RELAXED);
+      __atomic_fetch_add(&s->contended,contended,__ATOMIC_RELAXED);
+      __atomic_fetch_add(&s->wait_ns,wait,__ATOMIC_RELAXED);
+      return;
+    }
+  }
+  __atomic_fetch_add(&l->other_acq,1,__ATOMIC_RELAXED);
+  __atomic_fetch_add(&l->other_wait_ns,wait,__ATOMIC_RELAXED);
+}
+
+/* this thread holds l since t0                                       */
+static void pushHeld(Lock *l, uint64_t t0)
+{
+  int i;
+
+  /* semaphores used as signals are never posted by the waiter: keep
+   * one entry per lock and forget the oldest one when full           */
+  for (i=0; i<nheld; i++)
+    if (held[i].l == l && l->kind == LOCK_SEM) break;
+  if (i == nheld && nheld == LOCKPROF_MAX_HELD)
+    for (i=0, nheld--; i<nheld; i++) held[i]=held[i+1];
+  held[i]=(Held){l,t0};
+  if (i == nheld) nheld++;
+}
+
+/* this thread releases l: hold time since the latest pushHeld         */
+static void popHeld(Lock *l, uint64_t t1)
+{
+  uint64_t hold;
+  int i;
+
+  for (i=nheld-1; i>=0 && held[i].l != l; i--);
+  if (i < 0) return;
+  hold=t1-held[i].t0;
+  for (nheld--; i<nheld; i++) held[i]=held[i+1];
+  __atomic_fetch_add(&l->holds,1,__ATOMIC_RELAXED);
+  __atomic_fetch_add(&l->hold_ns,hold,__ATOMIC_RELAXED);
+  __atomic_fetch_add(&l->hold_hist[bucket(hold)],1,__ATOMIC_RELAXED);
+  atomicMax(&l->hold_max,hold);
+}
+
+static void acquired(Lock *l, void *pc, int contended, uint64_t wait, uint64_t t)
+{
+  __atomic_fetch_add(&l->acq,1,__ATOMIC_RELAXED);
+  __atomic_fetch_add(&l->contended,contended,__ATOMIC_RELAXED);
+  __atomic_fetch_add(&l->wait_ns,wait,__ATOMIC_RELAXED);
+  __atomic_fetch_add(&l->wait_hist[bucket(wait)],1,__ATOMIC_RELAXED);
+  atomicMax(&l->wait_max,wait);
+  countSite(l,pc,contended,wait);
+  pushHeld(l,t);
+}
+
+static void initialized(void *addr, int kind, void *pc)
+{
+  Lock *l=lookup(addr,kind,pc);
+
+  if (l == NULL) return;
+  l->kind=kind;
+  l->first_pc=pc;
+  if (pending[0] != '\0') lockprofName(addr,pending);
+}
+
+
+// MUTEX //
+int __wrap_pthread_mutex_init(pthread_mutex_t *m, const pthread_mutexattr_t *a)
+{
+  int ret=__real_pthread_mutex_init(m,a);
+
+  if (ret == 0) initialized(m,LOCK_MUTEX,__builtin_return_address(0));
+  return ret;
+}
+
+int __wrap_pthread_mutex_lock(pthread_mutex_t *m)
+{
+  void *pc=__builtin_return_address(0);
+  Lock *l=lookup(m,LOCK_MUTEX,pc);
+  uint64_t t0, t1;
+  int ret;
+
+  if (l == NULL) return __real_pthread_mutex_lock(m);
+  if ((ret=__real_pthread_mutex_trylock(m)) == EBUSY)
+  {
+    t0=now_ns();
+    ret=__real_pthread_mutex_lock(m);
+    t1=now_ns();
+    if (ret == 0) acquired(l,pc,1,t1-t0,t1);
+  }
+  else if (ret == 0) acquired(l,pc,0,0,now_ns());
+  return ret;
+}
+
+int __wrap_pthread_mutex_trylock(pthread_mutex_t *m)
+{
+  void *pc=__builtin_return_address(0);
+  Lock *l=lookup(m,LOCK_MUTEX,pc);
+  int ret=__real_pthread_mutex_trylock(m);
+
+  if (ret == 0 && l != NULL) acquired(l,pc,0,0,now_ns());
+  return ret;
+}
+
+int __wrap_pthread_mutex_unlock(pthread_mutex_t *m)
+{
+  Lock *l=lookup(m,LOCK_MUTEX,__builtin_return_address(0));
+
+  if (l != NULL) popHeld(l,now_ns());
+  return __real_pthread_mutex_unlock(m);
+}
+
+/* the time inside the wait is neither wait for nor hold of the mutex  */
+int __wrap_pthread_cond_wait(pthread_cond_t *c, pthread_mutex_t *m)
+{
+  Lock *l=lookup(m,LOCK_MUTEX,__builtin_return_address(0));
+  int ret;
+
+  if (l != NULL) popHeld(l,now_ns());
+  ret=__real_pthread_cond_wait(c,m);
+  if (l != NULL) pushHeld(l,now_ns());
+  return ret;
+}
+
+int __wrap_pthread_cond_timedwait(pthread_cond_t *c, pthread_mutex_t *m,
+                                  const struct timespec *abstime)
+{
+  Lock *l=lookup(m,LOCK_MUTEX,__builtin_return_address(0));
+  int ret;
+
+  if (l != NULL) popHeld(l,now_ns());
+  ret=__real_pthread_cond_timedwait(c,m,abstime);
+  if (l != NULL) pushHeld(l,now_ns());
+  return ret;
+}
+// END MUTEX //
+
+
+// SEMAPHORE //
+int __wrap_sem_init(sem_t *s, int pshared, unsigned int value)
+{
+  int ret=__real_sem_init(s,pshared,value);
+
+  if (ret == 0) initialized(s,LOCK_SEM,__builtin_return_address(0));
+  return ret;
+}
+
+int __wrap_sem_wait(sem_t *s)
+{
+  void *pc=__builtin_return_address(0);
+  Lock *l=lookup(s,LOCK_SEM,pc);
+  uint64_t t0, t1;
+  int ret;
+
+  if (l == NULL) return __real_sem_wait(s);
+  if ((ret=__real_sem_trywait(s)) < 0 && errno == EAGAIN)
+  {
+    t0=now_ns();
+    ret=__real_sem_wait(s);
+    t1=now_ns();
+    if (ret == 0) acquired(l,pc,1,t1-t0,t1);
+  }
+  else if (ret == 0) acquired(l,pc,0,0,now_ns());
+  return ret;
+}
+
+int __wrap_sem_trywait(sem_t *s)
+{
+  void *pc=__builtin_return_address(0);
+  Lock *l=lookup(s,LOCK_SEM,pc);
+  int ret=__real_sem_trywait(s);
+
+  if (ret == 0 && l != NULL) acquired(l,pc,0,0,now_ns());
+  return ret;
+}
+
+int __wrap_sem_timedwait(sem_t *s, const struct timespec *abstime)
+{
+  void *pc=__builtin_return_address(0);
+  Lock *l=lookup(s,LOCK_SEM,pc);
+  uint64_t t0, t1;
+  int ret;
+
+  if (l == NULL) return __real_sem_timedwait(s,abstime);
+  if ((ret=__real_sem_trywait(s)) < 0 && errno == EAGAIN)
+  {
+    t0=now_ns();
+    ret=__real_sem_timedwait(s,abstime);
+    t1=now_ns();
+    if (ret == 0) acquired(l,pc,1,t1-t0,t1);
+  }
+  else if (ret == 0) acquired(l,pc,0,0,now_ns());
+  return ret;
+}
+
+/* hold time only when the poster is the thread that took it           */
+int __wrap_sem_post(sem_t *s)
+{
+  Lock *l=lookup(s,LOCK_SEM,__builtin_return_address(0));
+
+  if (l != NULL) popHeld(l,now_ns());
+  return __real_sem_post(s);
+}
+// END SEMAPHORE //
+
+
+// NAMES //
+/* the mutex of a List is created inside createList: name it after it  */
+List_ptr_t __wrap_createList(char *listname, char *elemname, int debug)
+{
+  List_ptr_t l;
+
+  snprintf(pending,sizeof(pending),"List %s",listname);
+  l=__real_createList(listname,elemname,debug);
+  pending[0]='\0';
+  return l;
+}
+
+void lockprofName(void *addr, const char *name)
+{
+  Lock *l=lookup(addr,LOCK_MUTEX,__builtin_return_address(0));
+
+  if (l == NULL) return;
+  strncpy(l->name,name,NAME_LEN-1);
+  l->name[NAME_LEN-1]='\0';
+}
+
+/* symbol+offset of a code address, or file+offset if not exported    */
+static void codeName(void *pc, char *buf, size_t len)
+{
+  const char *file;
+  Dl_info info;
+
+  if (pc == NULL || dladdr(pc,&info) == 0)
+    snprintf(buf,len,"%p",pc);
+  else if (info.dli_sname != NULL)
+    snprintf(buf,len,"%s+0x%lx",info.dli_sname,
+             (unsigned long)((char*)pc-(char*)info.dli_saddr));
+  else
+  {
+    file=strrchr(info.dli_fname,'/');
+    snprintf(buf,len,"%s+0x%lx",file ? file+1 : info.dli_fname,
+             (unsigned long)((char*)pc-(char*)info.dli_fbase));
+  }
+}
+
+/* given name, global symbol, or init function and creation order     */
+static void lockName(Lock *l, Lock **all, int n, char *buf, size_t len)
+{
+  char func[NAME_LEN], other[NAME_LEN];
+  Dl_info info;
+  int i, k;
+
+  if (l->name[0] != '\0')
+    snprintf(buf,len,"%s",l->name);
+  else if (dladdr(l->addr,&info) != 0 && info.dli_sname != NULL &&
+           info.dli_saddr == l->addr)
+    snprintf(buf,len,"%s",info.dli_sname);
+  else
+  {
+    codeName(l->first_pc,func,sizeof(func));
+    if (strchr(func,'+') != NULL) *strchr(func,'+')='\0';
+    for (i=k=0; i<n; i++)
+    {
+      if (all[i]->seq >= l->seq || all[i]->name[0] != '\0') continue;
+      codeName(all[i]->first_pc,other,sizeof(other));
+      if (strchr(other,'+') != NULL) *strchr(other,'+')='\0';
+      if (strcmp(func,other) == 0) k++;
+    }
+    snprintf(buf,len,"%s#%d",func,k);
+  }
+}
+// END NAMES //
+
+
+// REPORT //
+static const char *fmtns(uint64_t ns, char *buf)
+{
+  if (ns < 1000) sprintf(buf,"%luns",(unsigned long)ns);
+  else if (ns < 1000000) sprintf(buf,"%.1fus",ns/1e3);
+  else if (ns < 1000000000) sprintf(buf,"%.1fms",ns/1e6);
+  else sprintf(buf,"%.2fs",ns/1e9);
+  return buf;
+}
+
+static int byWait(const void *a, const void *b)
+{
+  const Lock *x=*(Lock* const*)a, *y=*(Lock* const*)b;
+
+  if (x->wait_ns != y->wait_ns) return (x->wait_ns < y->wait_ns) ? 1 : -1;
+  return (x->acq < y->acq) ? 1 : (x->acq > y->acq) ? -1 : 0;
+}
+
+static int bySiteWait(const void *a, const void *b)
+{
+  const Site *x=a, *y=b;
+
+  if (x->wait_ns != y->wait_ns) return (x->wait_ns < y->wait_ns) ? 1 : -1;
+  return (x->acq < y->acq) ? 1 : (x->acq > y->acq) ? -1 : 0;
+}
+
+void lockprofDump(FILE *f)
+{
+  static Lock *all[LOCKPROF_MAX_LOCKS];
+  Site site[LOCKPROF_MAX_SITES];
+  char name[2*NAME_LEN], t1[16], t2[16], t3[16], t4[16];
+  Lock *l;
+  int n, i, j, b;
+
+  for (i=n=0; i<LOCKPROF_MAX_LOCKS; i++)
+    if (table[i].addr != NULL && table[i].acq > 0) all[n++]=&table[i];
+  qsort(all,n,sizeof(Lock*),byWait);
+
+  /* one line per lock                                                */
+  fprintf(f,"\n==== Lock profile: %d locks, sorted by total wait ====\n",n);
+  fprintf(f,"%-24s %-5s %9s %9s %6s %9s %9s %9s %9s\n","lock","kind",
+          "acquired","contended","%","wait","wait max","hold avg","hold max");
+  for (i=0; i<n; i++)
+  {
+    l=all[i];
+    lockName(l,all,n,name,sizeof(name));
+    fprintf(f,"%-24.24s %-5s %9lu %9lu %5.1f%% %9s %9s %9s %9s\n",name,
+            l->kind == LOCK_SEM ? "sem" : "mutex",
+            (unsigned long)l->acq,(unsigned long)l->contended,
+            100.0*l->contended/l->acq,fmtns(l->wait_ns,t1),fmtns(l->wait_max,t2),
+            l->holds ? fmtns(l->hold_ns/l->holds,t3) : "-",
+            l->holds ? fmtns(l->hold_max,t4) : "-");
+  }
+
+  /* histograms and call sites of the locks that made threads wait    */
+  for (i=0; i<n && i<LOCKPROF_TOP; i++)
+  {
+    l=all[i];
+    if (l->contended == 0) break;
+    lockName(l,all,n,name,sizeof(name));
+    fprintf(f,"\n%s (%s %p)\n",name,l->kind == LOCK_SEM ? "sem" : "mutex",l->addr);
+    fprintf(f,"  %-19s %10s %10s\n","time","waits","holds");
+    for (b=0; b<LOCKPROF_BUCKETS; b++)
+    {
+      if (l->wait_hist[b] == 0 && l->hold_hist[b] == 0) continue;
+      fprintf(f,"  [%7s,%7s) %10lu %10lu\n",fmtns(b ? 1ULL<<b : 0,t1),
+              b < LOCKPROF_BUCKETS-1 ? fmtns(1ULL<<(b+1),t2) : "inf",
+              (unsigned long)l->wait_hist[b],(unsigned long)l->hold_hist[b]);
+    }
+
+    memcpy(site,l->site,sizeof(site));
+    qsort(site,LOCKPROF_MAX_SITES,sizeof(Site),bySiteWait);
+    for (j=0; j<LOCKPROF_MAX_SITES && site[j].pc != NULL; j++)
+    {
+      codeName(site[j].pc,name,sizeof(name));
+      fprintf(f,"  site %-32s acquired %8lu contended %8lu wait %s\n",name,
+              (unsigned long)site[j].acq,(unsigned long)site[j].contended,
+              fmtns(site[j].wait_ns,t1));
+    }
+    if (l->other_acq > 0)
+      fprintf(f,"  site %-32s acquired %8lu                   wait %s\n","(other)",
+              (unsigned long)l->other_acq,fmtns(l->other_wait_ns,t1));
+  }
+  fprintf(f,"\n");
+  fflush(f);
+}
+
+/* the report is written before the World is torn down: the programs
+ * are already stopped and destroyWorld may block on a lock left taken
+ * by a cancelled thread                                              */
+void __wrap_destroyWorld(World_ptr_t w)
+{
+  const char *path=getenv("SIMUSIL_LOCKPROF");
+  FILE *f;
+
+  if (path != NULL && (f=fopen(path,"w")) != NULL)
+  {
+    lockprofDump(f);
+    fclose(f);
+  }
+  else
+    lockprofDump(stderr);
+  __real_destroyWorld(w);
+}
+// END REPORT //
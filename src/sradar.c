@@ -0,0 +1,403 @@
+/*
+ * File: sradar.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Compile: $ gcc -Wall -I./include -c src/sradar.c -o src/sradar.o
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#define _GNU_SOURCE   /* pthread_setaffinity_np(3), CPU_SET(3)        */
+#include <stdio.h>    /* printf(3)                                    */
+#include <stdlib.h>   /* malloc(3), calloc(3), realloc(3), free(3)    */
+#include <string.h>   /* memset(3)                                    */
+#include <stdint.h>   /* uint64_t, uintptr_t                          */
+#include <time.h>     /* clock_nanosleep(2), clock_gettime(2)         */
+#include <unistd.h>   /* sysconf(3)                                   */
+#include <pthread.h>  /* pthread stuff (_create,_join,_mutex)         */
+#include <sched.h>    /* cpu_set_t                                    */
+#include "sradar.h"
+
+#define RETAIN_NS 1000000000L /* final states kept 1s for the readers */
+#define RADAR_SHARE 4         /* refreshers hold the Radar <= 1/4 time  */
+#define CACHELINE 64
+
+/* a missile in the follow set of a sector                            */
+typedef struct{
+  Missile_ptr_t m;
+  Pos p;
+  MissileState st;
+  int done;              /* intercepted or impacted: no more polling  */
+  struct timespec until; /* when a done entry can be dropped          */
+  int next;              /* next entry of its hash bucket, -1 = none  */
+}Entry;
+
+typedef struct{
+  pthread_mutex_t lock;  /* protects follow, bucket, n, cap and reads */
+  Entry *follow;
+  int *bucket;           /* first entry of each bucket, cap of them   */
+  int n, cap;
+  unsigned long reads;
+  List_ptr_t New;        /* new missiles of this sector (own lock)    */
+  pthread_t thid;        /* refresher                                 */
+  int id;
+  struct SRadar *sr;
+} __attribute__((aligned(CACHELINE))) Sector;
+
+struct SRadar{
+  Radar_ptr_t r;
+  int nsectors;
+  int width;
+  long period;
+  int debug;
+  volatile int stop;
+  pthread_t feeder;
+  Sector *s;
+};
+
+static struct timespec addNs(struct timespec ts, long ns)
+{
+  ts.tv_nsec += ns;
+  while (ts.tv_nsec >= 1000000000)
+  {
+    ts.tv_nsec -= 1000000000;
+    ++ts.tv_sec;
+  }
+  return ts;
+}
+
+static int expired(const struct timespec *t, const struct timespec *now)
+{
+  return (t->tv_sec < now->tv_sec) ||
+         (t->tv_sec == now->tv_sec && t->tv_nsec <= now->tv_nsec);
+}
+
+/* follow set helpers: caller holds the sector lock. The entries are
+ * kept dense for the refresher and chained in cap hash buckets keyed
+ * by the Missile (cap is a power of 2)                               */
+static int hashMissile(Missile_ptr_t m, int cap)
+{
+  uint64_t h=((uint64_t)(uintptr_t)m >> 4)*0x9E3779B97F4A7C15ULL;
+  return (int)(h >> 32) & (cap-1);
+}
+
+static void linkEntry(Sector *s, int i)
+{
+  int *b=&s->bucket[hashMissile(s->follow[i].m,s->cap)];
+
+  s->follow[i].next=*b;
+  *b=i;
+}
+
+static void unlinkEntry(Sector *s, int i)
+{
+  int *b=&s->bucket[hashMissile(s->follow[i].m,s->cap)];
+
+  while (*b != i) b=&s->follow[*b].next;
+  *b=s->follow[i].next;
+}
+
+static int findEntry(Sector *s, Missile_ptr_t m)
+{
+  int i;
+
+  if (s->cap == 0) return -1;
+  for (i=s->bucket[hashMissile(m,s->cap)]; i >= 0; i=s->follow[i].next)
+    if (s->follow[i].m == m) return i;
+  return -1;
+}
+
+static void delEntry(Sector *s, int i)
+{
+  unlinkEntry(s,i);
+  if (i != --s->n)
+  {
+    unlinkEntry(s,s->n);
+    s->follow[i]=s->follow[s->n];
+    linkEntry(s,i);
+  }
+}
+
+static void addEntry(Sector *s, Missile_ptr_t m, Pos p, MissileState st)
+{
+  int i;
+
+  /* the Missile may reuse the memory of a retained final entry       */
+  if ((i=findEntry(s,m)) >= 0) delEntry(s,i);
+  if (s->n == s->cap)
+  {
+    s->cap = s->cap ? 2*s->cap : 32;
+    s->follow = realloc(s->follow,s->cap*sizeof(Entry));
+    s->bucket = realloc(s->bucket,s->cap*sizeof(int));
+    memset(s->bucket,0xff,s->cap*sizeof(int));  /* all -1            */
+    for (i=0; i<s->n; i++) linkEntry(s,i);
+  }
+  memset(&s->follow[s->n],0,sizeof(Entry));
+  s->follow[s->n].m=m;
+  s->follow[s->n].p=p;
+  s->follow[s->n].st=st;
+  linkEntry(s,s->n++);
+}
+
+/* feeder thread: the only caller of radarWaitMissile                 */
+static void *feeder(void *arg)
+{
+  SRadar_ptr_t sr=arg;
+  Missile_ptr_t m;
+  MissileState st;
+  Sector *s;
+  Pos p;
+  int old;
+  static int count=0;
+
+  while (1)
+  {
+    m=radarWaitMissile(sr->r);
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE,&old);
+    st=radarReadMissile(sr->r,m,&p);
+    if (st == MISSILE_ACTIVE)
+    {
+      s=&sr->s[sradarSector(sr,p.x)];
+      pthread_mutex_lock(&s->lock);
+      addEntry(s,m,p,st);
+      pthread_mutex_unlock(&s->lock);
+      list_enqueue(m,count++,s->New);
+    }
+    pthread_setcancelstate(old,NULL);
+  }
+  return NULL; /* never reached!                                      */
+}
+
+/* refresher thread: polls the Radar for the missiles of one sector   */
+static void *refresher(void *arg)
+{
+  Sector *s=arg, *t;
+  SRadar_ptr_t sr=s->sr;
+  Missile_ptr_t *snap=NULL;
+  Pos *pos=NULL;
+  MissileState *st=NULL;
+  struct timespec next, now, done;
+  long wait=sr->period, busy;
+  int nsnap, cap=0, i, k, dst;
+
+  sradarBindThread(sr,s->id);
+  clock_gettime(CLOCK_MONOTONIC,&next);
+  while (!sr->stop)
+  {
+    next=addNs(next,wait);
+    clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&next,NULL);
+    clock_gettime(CLOCK_MONOTONIC,&now);
+
+    /* 1) snapshot of the live missiles, drop old final states        */
+    pthread_mutex_lock(&s->lock);
+    if (cap < s->n)
+    {
+      cap=s->cap;
+      snap=realloc(snap,cap*sizeof(Missile_ptr_t));
+      pos=realloc(pos,cap*sizeof(Pos));
+      st=realloc(st,cap*sizeof(MissileState));
+    }
+    for (i=nsnap=0; i<s->n; )
+    {
+      if (s->follow[i].done)
+      {
+        if (expired(&s->follow[i].until,&now)) delEntry(s,i);
+        else i++;
+        continue;
+      }
+      snap[nsnap++]=s->follow[i++].m;
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    /* 2) ask the Radar without holding the sector lock               */
+    for (i=0; i<nsnap; i++)
+      st[i]=radarReadMissile(sr->r,snap[i],&pos[i]);
+    /* every sector polls the single Radar lock: with many missiles the
+     * period grows so that all of them together take 1/RADAR_SHARE   */
+    clock_gettime(CLOCK_MONOTONIC,&done);
+    busy=(done.tv_sec-now.tv_sec)*1000000000L+(done.tv_nsec-now.tv_nsec);
+    wait=RADAR_SHARE*sr->nsectors*busy;
+    if (wait < sr->period) wait=sr->period;
+
+    /* 3) publish, hand over missiles that left the sector            */
+    for (i=0; i<nsnap; i++)
+    {
+      dst = (st[i] == MISSILE_ACTIVE) ? sradarSector(sr,pos[i].x) : s->id;
+      pthread_mutex_lock(&s->lock);
+      if ((k=findEntry(s,snap[i])) >= 0)
+      {
+        s->follow[k].p=pos[i];
+        s->follow[k].st=st[i];
+        if (st[i] != MISSILE_ACTIVE)
+        {
+          s->follow[k].done=1;
+          s->follow[k].until=addNs(now,RETAIN_NS);
+        }
+        else if (dst != s->id)
+          delEntry(s,k);
+      }
+      pthread_mutex_unlock(&s->lock);
+      if (k >= 0 && dst != s->id)
+      {
+        t=&sr->s[dst];
+        pthread_mutex_lock(&t->lock);
+        addEntry(t,snap[i],pos[i],st[i]);
+        pthread_mutex_unlock(&t->lock);
+      }
+    }
+  }
+  free(snap);
+  free(pos);
+  free(st);
+  return NULL;
+}
+
+SRadar_ptr_t createSRadar(Radar_ptr_t r, int nsectors, int width, long period, int debug)
+{
+  SRadar_ptr_t sr;
+  Sector *s;
+  int i;
+
+  if (nsectors < 1) nsectors=1;
+  sr=(SRadar_ptr_t)calloc(1,sizeof(struct SRadar));
+  sr->r=r;
+  sr->nsectors=nsectors;
+  sr->width = width > 0 ? width : SRADAR_DEFAULT_WIDTH;
+  sr->period = period > 0 ? period : SRADAR_DEFAULT_PERIOD;
+  sr->debug=debug;
+  if (posix_memalign((void**)&sr->s,CACHELINE,nsectors*sizeof(Sector)) != 0)
+  {
+    free(sr);
+    return NULL;
+  }
+  memset(sr->s,0,nsectors*sizeof(Sector));
+  for (i=0; i<nsectors; i++)
+  {
+    s=&sr->s[i];
+    pthread_mutex_init(&s->lock,NULL);
+    s->New=createList("SRadar.New","missile",debug);
+    s->id=i;
+    s->sr=sr;
+    pthread_create(&s->thid,NULL,refresher,s);
+  }
+  pthread_create(&sr->feeder,NULL,feeder,sr);
+  if (debug <= debug_getlevel())
+    printf("SRadar: %d sectors of %d created (debug level=%d)\n",
+           nsectors,(sr->width+nsectors-1)/nsectors,debug);
+  return sr;
+}
+
+void destroySRadar(SRadar_ptr_t sr)
+{
+  Sector *s;
+  int i;
+
+  pthread_cancel(sr->feeder);
+  pthread_join(sr->feeder,NULL);
+  sr->stop=1;
+  for (i=0; i<sr->nsectors; i++)
+  {
+    s=&sr->s[i];
+    pthread_join(s->thid,NULL);
+    if (sr->debug <= debug_getlevel())
+      printf("SRadar.%d: %lu reads, %d followed\n",i,s->reads,s->n);
+    destroyList(s->New,NULL);
+    free(s->follow);
+    free(s->bucket);
+    pthread_mutex_destroy(&s->lock);
+  }
+  free(sr->s);
+  free(sr);
+}
+
+int sradarNumSectors(SRadar_ptr_t sr)
+{
+  return sr->nsectors;
+}
+
+int sradarSector(SRadar_ptr_t sr, int x)
+{
+  int i;
+
+  if (x < 0) return 0;
+  i=(int)((long)x*sr->nsectors/sr->width);
+  return i < sr->nsectors ? i : sr->nsectors-1;
+}
+
+Missile_ptr_t sradarWaitMissile(SRadar_ptr_t sr, int sector)
+{
+  return list_dequeue(sr->s[sector].New,1);
+}
+
+Missile_ptr_t sradarPollMissile(SRadar_ptr_t sr, int sector)
+{
+  return list_dequeue(sr->s[sector].New,0);
+}
+
+MissileState sradarReadMissile(SRadar_ptr_t sr, Missile_ptr_t m, int *sector, Pos *p)
+{
+  MissileState st;
+  Sector *s;
+  int i, j, k, stale=-1;
+
+  /* hinted sector first, then its neighbours outwards. A final entry
+   * elsewhere may belong to a former Missile at the same address: it
+   * is only used if no sector follows a live one                     */
+  for (j=0; j<2*sr->nsectors; j++)
+  {
+    i = *sector + ((j&1) ? -(j+1)/2 : j/2);
+    if (i < 0 || i >= sr->nsectors) continue;
+    s=&sr->s[i];
+    pthread_mutex_lock(&s->lock);
+    if ((k=findEntry(s,m)) >= 0 && (!s->follow[k].done || i == *sector))
+    {
+      *p=s->follow[k].p;
+      st=s->follow[k].st;
+      s->reads++;
+      pthread_mutex_unlock(&s->lock);
+      *sector=i;
+      return st;
+    }
+    pthread_mutex_unlock(&s->lock);
+    if (k >= 0 && stale < 0) stale=i;
+  }
+  if (stale >= 0)
+  {
+    s=&sr->s[stale];
+    pthread_mutex_lock(&s->lock);
+    if ((k=findEntry(s,m)) >= 0)
+    {
+      *p=s->follow[k].p;
+      st=s->follow[k].st;
+      s->reads++;
+      pthread_mutex_unlock(&s->lock);
+      *sector=stale;
+      return st;
+    }
+    pthread_mutex_unlock(&s->lock);
+  }
+  return radarReadMissile(sr->r,m,p); /* not followed: ask the Radar  */
+}
+
+int sradarBindThread(SRadar_ptr_t sr, int sector)
+{
+  cpu_set_t set;
+  long ncpu=sysconf(_SC_NPROCESSORS_ONLN);
+
+  CPU_ZERO(&set);
+  CPU_SET(sector % (ncpu > 0 ? ncpu : 1),&set);
+  return pthread_setaffinity_np(pthread_self(),sizeof(set),&set);
+}
+
+unsigned long sradarReads(SRadar_ptr_t sr, int sector)
+{
+  unsigned long n;
+
+  pthread_mutex_lock(&sr->s[sector].lock);
+  n=sr->s[sector].reads;
+  pthread_mutex_unlock(&sr->s[sector].lock);
+  return n;
+}
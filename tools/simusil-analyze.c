@@ -0,0 +1,197 @@
+/*
+ * File: simusil-analyze.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Offline analysis of a journal written with journalOpen()/journalLog().
+ * The file is read once, sequentially, in big blocks; only a small
+ * summary per missile is kept in memory, so multi-GB journals are fine.
+ *
+ * Compile: $ make simusil-analyze
+ *
+ * Usage:   $ ./simusil-analyze [-t] journal_file
+ *                -t  print the timeline of every missile (ms since start)
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include <stdio.h>  /* printf(3), fopen(3), fread(3)                  */
+#include <stdlib.h> /* exit(3), calloc(3), realloc(3)                 */
+#include <string.h> /* memcmp(3), memset(3), strcmp(3)                */
+#include "journal.h"
+
+#define BLOCK 65536 /* records per read                               */
+
+/* what we remember of every missile: first time of every event        */
+typedef struct{
+  uint64_t t[JOURNAL_NUM_EVENTS];
+  int32_t  x, y;    /* last known position                            */
+}Timeline;
+
+/* running min/avg/max of an interval between two events              */
+typedef struct{
+  const char *name;
+  JournalEvent from, to;
+  uint64_t n, sum, min, max;
+}Interval;
+
+Interval intervals[]={
+  {"detect -> schedule",     JOURNAL_DETECT,    JOURNAL_SCHEDULE},
+  {"schedule -> move_start", JOURNAL_SCHEDULE,  JOURNAL_MOVE_START},
+  {"move_start -> move_end", JOURNAL_MOVE_START,JOURNAL_MOVE_END},
+  {"move_end -> fire",       JOURNAL_MOVE_END,  JOURNAL_FIRE},
+  {"detect -> fire",         JOURNAL_DETECT,    JOURNAL_FIRE},
+  {"fire -> intercept",      JOURNAL_FIRE,      JOURNAL_INTERCEPT},
+  {"detect -> impact",       JOURNAL_DETECT,    JOURNAL_IMPACT},
+};
+#define NINTERVALS (sizeof(intervals)/sizeof(intervals[0]))
+
+Timeline *tl=NULL;
+uint64_t ntl=0;
+
+Timeline *getTimeline(uint32_t id)
+{
+  uint64_t n;
+
+  if (id >= ntl)
+  {
+    n = ntl ? ntl : 1024;
+    while (n <= id) n*=2;
+    tl=realloc(tl,n*sizeof(Timeline));
+    if (tl == NULL)
+    {
+      perror("realloc");
+      exit(EXIT_FAILURE);
+    }
+    memset(tl+ntl,0,(n-ntl)*sizeof(Timeline));
+    ntl=n;
+  }
+  return &tl[id];
+}
+
+void usage(char *prog)
+{
+  fprintf(stderr,"Usage: %s [-t] journal_file\n",prog);
+  exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+  JournalHeader h;
+  JournalRecord *buf;
+  Timeline *m;
+  FILE *f;
+  uint64_t count[JOURNAL_NUM_EVENTS]={0};
+  uint64_t total=0, torn=0, nmissiles=0, last_ns=0, d, id;
+  uint64_t intercepted=0, impacted=0, lost=0, open=0, left;
+  size_t n, i, k;
+  int timeline=0;
+  char *path=NULL;
+
+  for (i=1; i<argc; i++)
+  {
+    if (strcmp(argv[i],"-t") == 0) timeline=1;
+    else if (path == NULL) path=argv[i];
+    else usage(argv[0]);
+  }
+  if (path == NULL) usage(argv[0]);
+
+  if ((f=fopen(path,"rb")) == NULL)
+  {
+    perror(path);
+    exit(EXIT_FAILURE);
+  }
+  if (fread(&h,sizeof(h),1,f) != 1 ||
+      memcmp(h.magic,JOURNAL_MAGIC,sizeof(h.magic)) != 0 ||
+      h.version != JOURNAL_VERSION || h.recsize != sizeof(JournalRecord))
+  {
+    fprintf(stderr,"%s: not a simusil journal (version %d)\n",path,JOURNAL_VERSION);
+    exit(EXIT_FAILURE);
+  }
+  buf=malloc(BLOCK*sizeof(JournalRecord));
+  /* slots reserved so far: a killed run leaves the file untrimmed      */
+  left = h.next < h.capacity ? h.next : h.capacity;
+
+  /* single streaming pass                                            */
+  while (left > 0 &&
+         (n=fread(buf,sizeof(JournalRecord),left < BLOCK ? left : BLOCK,f)) > 0)
+  {
+    left-=n;
+    for (i=0; i<n; i++)
+    {
+      JournalRecord *r=&buf[i];
+      if (r->event == JOURNAL_NONE || r->event >= JOURNAL_NUM_EVENTS)
+      {
+        torn++;  /* slot reserved but never published (killed run)    */
+        continue;
+      }
+      total++;
+      count[r->event]++;
+      if (r->t_ns > last_ns) last_ns=r->t_ns;
+      m=getTimeline(r->id);
+      if (m->t[r->event] == 0) m->t[r->event]=r->t_ns;
+      m->x=r->x;
+      m->y=r->y;
+    }
+  }
+  fclose(f);
+  free(buf);
+
+  /* per-missile pass over the (small) summary                        */
+  for (id=0; id<ntl; id++)
+  {
+    m=&tl[id];
+    for (k=0; k<JOURNAL_NUM_EVENTS && m->t[k] == 0; k++);
+    if (k == JOURNAL_NUM_EVENTS) continue;
+    nmissiles++;
+    if (m->t[JOURNAL_INTERCEPT]) intercepted++;
+    else if (m->t[JOURNAL_IMPACT]) impacted++;
+    else if (m->t[JOURNAL_LOST]) lost++;
+    else open++;
+    for (k=0; k<NINTERVALS; k++)
+    {
+      Interval *iv=&intervals[k];
+      if (m->t[iv->from] == 0 || m->t[iv->to] == 0 ||
+          m->t[iv->to] < m->t[iv->from]) continue;
+      d=m->t[iv->to]-m->t[iv->from];
+      if (iv->n == 0 || d < iv->min) iv->min=d;
+      if (d > iv->max) iv->max=d;
+      iv->sum+=d;
+      iv->n++;
+    }
+    if (timeline)
+    {
+      printf("Missile %3lu:",(unsigned long)id);
+      for (k=1; k<JOURNAL_NUM_EVENTS; k++)
+        if (m->t[k])
+          printf(" %s@%.3f",journalEventName(k),(m->t[k]-h.start_ns)/1e6);
+      printf(" last [%d,%d]\n",m->x,m->y);
+    }
+  }
+
+  printf("Journal %s: %lu events, %lu missiles, %.3f s\n",path,
+         (unsigned long)total,(unsigned long)nmissiles,
+         last_ns > h.start_ns ? (last_ns-h.start_ns)/1e9 : 0.0);
+  if (torn) printf("  %lu unpublished slots skipped\n",(unsigned long)torn);
+  for (k=1; k<JOURNAL_NUM_EVENTS; k++)
+    printf("  %-12s %10lu\n",journalEventName(k),(unsigned long)count[k]);
+  printf("Outcome: intercepted %lu, impacted %lu, lost %lu, unresolved %lu\n",
+         (unsigned long)intercepted,(unsigned long)impacted,
+         (unsigned long)lost,(unsigned long)open);
+  if (intercepted+impacted > 0)
+    printf("Hit rate: %lu/%lu (%.1f%%)\n",(unsigned long)intercepted,
+           (unsigned long)(intercepted+impacted),
+           100.0*intercepted/(intercepted+impacted));
+  printf("%-24s %8s %10s %10s %10s\n","Interval (ms)","n","min","avg","max");
+  for (k=0; k<NINTERVALS; k++)
+  {
+    Interval *iv=&intervals[k];
+    if (iv->n == 0) continue;
+    printf("%-24s %8lu %10.3f %10.3f %10.3f\n",iv->name,(unsigned long)iv->n,
+           iv->min/1e6,(double)iv->sum/iv->n/1e6,iv->max/1e6);
+  }
+  free(tl);
+  exit(EXIT_SUCCESS);
+}
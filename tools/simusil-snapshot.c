@@ -0,0 +1,76 @@
+/*
+ * File: simusil-snapshot.c
+ *
+ * This file is part of the SimuSil library
+ *
+ * Builds a scenario and saves it with worldSave(): the missiles are
+ * launched by hand, spread over some milliseconds, with no radar nor
+ * cannons working, so every one is still in the sky (or already on the
+ * ground) when the World is saved. Load it with worldLoad() or with
+ * $ SIMUSIL_SNAPSHOT=file ./<prog>
+ *
+ * Compile: $ make simusil-snapshot
+ *
+ * Usage:   $ ./simusil-snapshot [-n missiles] [-t ms] [-c cannons] [-s seed] file
+ *                -n  missiles launched (60)
+ *                -t  milliseconds the launches are spread over (500)
+ *                -c  cannons of the World, their positions are saved (1)
+ *                -s  seed of drand48(3) (time(2) if not given)
+ *
+ * Author: Sergio Romero Montiel <sromero@uma.es>
+ *
+ * Created on October 19th, 2026
+ */
+
+#include <stdio.h>  /* printf(3), fprintf(3)                          */
+#include <stdlib.h> /* atoi(3), atol(3), exit(3), srand48(3)          */
+#include <string.h> /* strcmp(3)                                      */
+#include <time.h>   /* nanosleep(2), time(2)                          */
+#include "checkpoint.h"
+
+/* not in simusil.h: the function the Bomber calls for every missile  */
+void generateMissile(World_ptr_t);
+
+void usage(char *prog)
+{
+  fprintf(stderr,"Usage: %s [-n missiles] [-t ms] [-c cannons] [-s seed] file\n",prog);
+  exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+  World_ptr_t w;
+  struct timespec gap;
+  long nmissiles=60, ms=500, seed=time(NULL);
+  int ncannons=1, saved, i;
+  char *path=NULL;
+
+  for (i=1; i<argc; i++)
+  {
+    if (strcmp(argv[i],"-n") == 0 && i+1 < argc) nmissiles=atol(argv[++i]);
+    else if (strcmp(argv[i],"-t") == 0 && i+1 < argc) ms=atol(argv[++i]);
+    else if (strcmp(argv[i],"-c") == 0 && i+1 < argc) ncannons=atoi(argv[++i]);
+    else if (strcmp(argv[i],"-s") == 0 && i+1 < argc) seed=atol(argv[++i]);
+    else if (path == NULL && argv[i][0] != '-') path=argv[i];
+    else usage(argv[0]);
+  }
+  if (path == NULL || nmissiles < 0 || ms < 0 || ncannons < 1) usage(argv[0]);
+
+  srand48(seed);
+  debug_setlevel(-1);
+  w=createWorld("Snapshot",ncannons,0);
+  gap.tv_nsec=nmissiles ? ms*1000000L/nmissiles : 0;
+  gap.tv_sec=gap.tv_nsec/1000000000L;
+  gap.tv_nsec%=1000000000L;
+  for (i=0; i<nmissiles; i++)
+  {
+    generateMissile(w);
+    nanosleep(&gap,NULL);
+  }
+  saved=worldSave(w,path);
+  if (saved >= 0)
+    printf("%s: %d of %ld missiles in the sky (seed %ld)\n",
+           path,saved,nmissiles,seed);
+  destroyWorld(w);
+  return saved < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}